@@ -0,0 +1,28 @@
+#include "attacks.hpp"
+
+namespace attacks {
+
+std::array<std::uint64_t, rookTableSize> rookTable;
+std::array<std::uint64_t, bishopTableSize> bishopTable;
+
+namespace {
+
+template <std::size_t size, class F>
+bool fillTable(std::array<std::uint64_t, size>& table, const std::array<Magic, 64>& magics, F&& fillFunc) {
+    for (std::size_t i = 0; i < magics.size(); ++i) {
+        // enumerates every subset of the mask, starting and ending with the empty set
+        std::uint64_t obstacles = 0ul;
+        do {
+            table[magicIndex(magics[i], obstacles)] = fillFunc(1ul << i, obstacles);
+            obstacles = (obstacles - magics[i].mask) & magics[i].mask;
+        } while (obstacles);
+    }
+    return true;
+}
+
+const bool rookTableFilled = fillTable(rookTable, rookMagics, rookFill);
+const bool bishopTableFilled = fillTable(bishopTable, bishopMagics, bishopFill);
+
+} // namespace
+
+} // namespace attacks
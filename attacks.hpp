@@ -0,0 +1,198 @@
+#pragma once
+#include "move.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace attacks {
+
+constexpr const static std::uint64_t fileA = 0x0101010101010101ul;
+constexpr const static std::uint64_t fileH = fileA << 7;
+constexpr const static std::uint64_t rank8 = 0xfful;
+constexpr const static std::uint64_t rank1 = rank8 << 56;
+constexpr const static std::uint64_t edges = fileA | fileH | rank8 | rank1;
+
+// Moves every position one step into the given direction, dropping those that would leave the board.
+template <Direction dir>
+constexpr std::uint64_t shift(std::uint64_t positions) {
+    constexpr auto distance = getIntDir(dir);
+    positions &= hidden::getMask<dir, 1>();
+    if constexpr (distance > 0) {
+        return positions >> distance;
+    }
+    else {
+        return positions << -distance;
+    }
+}
+
+// All fields reachable from any of the positions by sliding into the given direction. The first obstacle on each ray
+// is included so captures are part of the result.
+template <Direction dir>
+constexpr std::uint64_t slide(std::uint64_t positions, std::uint64_t obstacles) {
+    std::uint64_t result = 0ul;
+    for (positions = shift<dir>(positions); positions; positions = shift<dir>(positions & ~obstacles)) {
+        result |= positions;
+    }
+    return result;
+}
+
+constexpr std::uint64_t knightAttacks(std::uint64_t positions) {
+    return shift<NNE>(positions) | shift<ENE>(positions) | shift<ESE>(positions) | shift<SSE>(positions) |
+        shift<SSW>(positions) | shift<WSW>(positions) | shift<WNW>(positions) | shift<NNW>(positions);
+}
+
+constexpr std::uint64_t kingAttacks(std::uint64_t positions) {
+    return shift<N>(positions) | shift<NE>(positions) | shift<E>(positions) | shift<SE>(positions) |
+        shift<S>(positions) | shift<SW>(positions) | shift<W>(positions) | shift<NW>(positions);
+}
+
+template <bool amIWhite>
+constexpr std::uint64_t pawnAttacks(std::uint64_t positions) {
+    if constexpr (amIWhite) {
+        return shift<NE>(positions) | shift<NW>(positions);
+    }
+    else {
+        return shift<SE>(positions) | shift<SW>(positions);
+    }
+}
+
+constexpr std::uint64_t rookFill(std::uint64_t positions, std::uint64_t obstacles) {
+    return slide<N>(positions, obstacles) | slide<E>(positions, obstacles) | slide<S>(positions, obstacles) |
+        slide<W>(positions, obstacles);
+}
+
+constexpr std::uint64_t bishopFill(std::uint64_t positions, std::uint64_t obstacles) {
+    return slide<NE>(positions, obstacles) | slide<SE>(positions, obstacles) | slide<SW>(positions, obstacles) |
+        slide<NW>(positions, obstacles);
+}
+
+template <class F>
+constexpr std::array<std::uint64_t, 64> generateTable(F&& func) {
+    std::array<std::uint64_t, 64> result{};
+    for (std::size_t i = 0; i < result.size(); ++i) {
+        result[i] = func(1ul << i);
+    }
+    return result;
+}
+
+constexpr const static auto knightTable = generateTable(knightAttacks);
+constexpr const static auto kingTable = generateTable(kingAttacks);
+constexpr const static auto whitePawnTable = generateTable(pawnAttacks<true>);
+constexpr const static auto blackPawnTable = generateTable(pawnAttacks<false>);
+
+template <bool amIWhite>
+constexpr const std::array<std::uint64_t, 64>& pawnTable() {
+    if constexpr (amIWhite) {
+        return whitePawnTable;
+    }
+    else {
+        return blackPawnTable;
+    }
+}
+
+// Fancy magic bitboards: the relevant obstacles of a slider are hashed into a perfect index of a per-square attack
+// table. The magic numbers were found by a brute force search for this board layout (bit 0 = a8, bit 63 = h1).
+struct Magic {
+    std::uint64_t mask;
+    std::uint64_t magic;
+    std::size_t offset;
+    unsigned shift;
+};
+
+constexpr const static std::array<std::uint64_t, 64> rookMagicNumbers{
+    0x8080008010204008ul, 0x8840009001200a40ul, 0x08801000ea200080ul, 0x6080100004800800ul,
+    0x0a00201062002408ul, 0x11000891004c0002ul, 0x0a000452850a0008ul, 0x0600010210204084ul,
+    0x1002002200408104ul, 0x8200402010004004ul, 0x9401002000110040ul, 0x0440801004820800ul,
+    0x1002800800240280ul, 0x4012000488020010ul, 0x2084004804100182ul, 0x1411800040800100ul,
+    0x0000908000400028ul, 0x2220004000483000ul, 0x8115010020084012ul, 0x0008028010008008ul,
+    0x0820808004000801ul, 0x0020808002000400ul, 0x0414840041283002ul, 0x02010e0008805409ul,
+    0x0000400980009020ul, 0x2400200240100040ul, 0x8830801200224200ul, 0x6000080080100080ul,
+    0x00c0040080080082ul, 0x0483002900040046ul, 0x0c42004200042958ul, 0x0101c08600040941ul,
+    0x0100400022800080ul, 0x0040400080802002ul, 0x0088408202001020ul, 0x0030801000800800ul,
+    0x0080040080800802ul, 0x0001000401000802ul, 0x00002a1014004801ul, 0x008010a042000409ul,
+    0x0080004020004001ul, 0x0020200050004000ul, 0x0400802200420010ul, 0x0514419200220008ul,
+    0x6608008004008008ul, 0x0804008002008004ul, 0x4844080110040002ul, 0x0120040060820001ul,
+    0x924002408000a480ul, 0x8012010020448200ul, 0x4101200184100680ul, 0x2002100180080480ul,
+    0x0006800801040180ul, 0x0400800400020080ul, 0x5220015230080400ul, 0x0080471409885200ul,
+    0xa000401029008005ul, 0xa000102040010081ul, 0x2005104088802202ul, 0x0000e02500300009ul,
+    0x004a000560081042ul, 0x8041000204000801ul, 0x628008049001061cul, 0x0000098021144402ul,
+};
+
+constexpr const static std::array<std::uint64_t, 64> bishopMagicNumbers{
+    0x0040015204250120ul, 0x0010904101182000ul, 0xc111010622000000ul, 0x2404440880100030ul,
+    0x0214042104106410ul, 0x0082020220101000ul, 0x0084014822100000ul, 0x80c4808050100450ul,
+    0x0158088810041040ul, 0x2100204440820050ul, 0x04aa100110410042ul, 0x080102408100061cul,
+    0x0004640420032000ul, 0x0000120290841508ul, 0x1000920a30048480ul, 0x8040122484302880ul,
+    0x0804094004282201ul, 0x10040c0808588420ul, 0x0010000200284100ul, 0x0004000241020104ul,
+    0x2002000406112500ul, 0x0010800100414001ul, 0xc054840202300201ul, 0x0013400022121000ul,
+    0xa890401234640440ul, 0x88014800e0420420ul, 0x0200241888080021ul, 0x0804010000200880ul,
+    0x0804082014002004ul, 0xc400882002021008ul, 0x0850810002180280ul, 0x0104444002090400ul,
+    0x1111984000a01400ul, 0x8004442000421200ul, 0x0601040201810804ul, 0x8200020080180080ul,
+    0x0560420020020080ul, 0x0110021421020080ul, 0x8031080488021208ul, 0x0209004a0401010aul,
+    0x1044100808000400ul, 0x2401041004900220ul, 0x8a91001804010210ul, 0x0000802011012804ul,
+    0x0000044094000200ul, 0x0a0400e800404200ul, 0x0044110202080428ul, 0x0008022406a100c2ul,
+    0x4101041004040000ul, 0x0003029801484000ul, 0x8000a10880b04502ul, 0x2041400884040008ul,
+    0x0014a21202020110ul, 0x2080041012620000ul, 0x0004083204242231ul, 0x0020410401004000ul,
+    0x2025002210040400ul, 0x0000021211041208ul, 0x8000000c42281408ul, 0x0000040410843400ul,
+    0x0002095360024400ul, 0xa608b81020010440ul, 0x1021045104012408ul, 0x20085101040c0088ul,
+};
+
+constexpr std::uint64_t rookMask(std::uint64_t position) {
+    return (slide<N>(position, 0ul) & ~rank8) | (slide<E>(position, 0ul) & ~fileH) | (slide<S>(position, 0ul) & ~rank1) |
+        (slide<W>(position, 0ul) & ~fileA);
+}
+
+constexpr std::uint64_t bishopMask(std::uint64_t position) { return bishopFill(position, 0ul) & ~edges; }
+
+template <class F>
+constexpr std::array<Magic, 64> generateMagics(const std::array<std::uint64_t, 64>& magicNumbers, F&& maskFunc) {
+    std::array<Magic, 64> result{};
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < result.size(); ++i) {
+        auto mask = maskFunc(1ul << i);
+        result[i] = Magic{mask, magicNumbers[i], offset, static_cast<unsigned>(64 - __builtin_popcountll(mask))};
+        offset += 1ul << __builtin_popcountll(mask);
+    }
+    return result;
+}
+
+constexpr const static auto rookMagics = generateMagics(rookMagicNumbers, rookMask);
+constexpr const static auto bishopMagics = generateMagics(bishopMagicNumbers, bishopMask);
+
+constexpr const static std::size_t rookTableSize = rookMagics[63].offset + (1ul << (64 - rookMagics[63].shift));
+constexpr const static std::size_t bishopTableSize = bishopMagics[63].offset + (1ul << (64 - bishopMagics[63].shift));
+static_assert(rookTableSize == 102400);
+static_assert(bishopTableSize == 5248);
+
+// Filled once at startup by attacks.cpp.
+extern std::array<std::uint64_t, rookTableSize> rookTable;
+extern std::array<std::uint64_t, bishopTableSize> bishopTable;
+
+constexpr std::size_t magicIndex(const Magic& magic, std::uint64_t obstacles) {
+    return magic.offset + (((obstacles & magic.mask) * magic.magic) >> magic.shift);
+}
+
+inline std::uint64_t rookAttacks(std::size_t square, std::uint64_t obstacles) {
+    return rookTable[magicIndex(rookMagics[square], obstacles)];
+}
+
+inline std::uint64_t bishopAttacks(std::size_t square, std::uint64_t obstacles) {
+    return bishopTable[magicIndex(bishopMagics[square], obstacles)];
+}
+
+inline std::uint64_t queenAttacks(std::size_t square, std::uint64_t obstacles) {
+    return rookAttacks(square, obstacles) | bishopAttacks(square, obstacles);
+}
+
+// Fields strictly between two fields sharing a rank, file or diagonal. Returns 0 if they are not aligned.
+inline std::uint64_t between(std::size_t from, std::size_t to) {
+    if (rookAttacks(from, 0ul) & (1ul << to)) {
+        return rookAttacks(from, 1ul << to) & rookAttacks(to, 1ul << from);
+    }
+    if (bishopAttacks(from, 0ul) & (1ul << to)) {
+        return bishopAttacks(from, 1ul << to) & bishopAttacks(to, 1ul << from);
+    }
+    return 0ul;
+}
+
+} // namespace attacks
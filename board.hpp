@@ -1,6 +1,9 @@
 #pragma once
+#include "attacks.hpp"
 #include "move.hpp"
 #include "piece.hpp"
+#include "pieceSquare.hpp"
+#include "zobrist.hpp"
 
 #include <array>
 #include <cassert>
@@ -10,16 +13,76 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 static std::array<std::uint64_t, 16> statistics{
     0ul, 0ul, 0ul, 0ul, 0ul, 0ul, 0ul, 0ul, 0ul, 0ul, 0ul, 0ul, 0ul, 0ul, 0ul, 0ul};
 
-template <bool amIWhite>
-struct Board {
+// Restricts the targets of generated moves. The pseudo-legal mask only keeps the king off threatened fields, the legal
+// mask additionally limits every piece to the check evasions and keeps pinned pieces on their pin ray. targets allows
+// generating captures and quiet moves separately, en passent counts as a capture of the pawn behind the target.
+struct MoveMask {
+    std::uint64_t evasions{~0ul};
+    std::uint64_t threatened{0ul};
+    std::uint64_t enPassentCapturers{~0ul};
+    std::uint64_t pinned{0ul};
+    std::array<std::uint64_t, 8> pinRays{};
+    std::uint64_t targets{~0ul};
+
+    constexpr std::uint64_t getTargets(std::uint64_t from) const {
+        if (!(from & pinned)) {
+            return evasions & targets;
+        }
+        for (auto ray : pinRays) {
+            if (ray & from) {
+                return evasions & targets & ray;
+            }
+        }
+        return 0ul;
+    }
+};
+
+// Number of pseudo-legal moves, once by the kind of piece that moves and once by what stands on the target field: None
+// for quiet moves and en passent. A promotion counts once for every piece it can turn into, like forEachValidMove.
+struct Mobility {
+    std::array<int, 16> moves{};
+    std::array<int, 16> targets{};
+};
+
+// Everything makeMove overwrites that can't be recomputed from the move itself.
+struct MoveUndo {
+    std::uint64_t enPassent;
+    std::array<bool, 4> castling;
+    std::uint8_t captured;
+    std::uint64_t hash;
+    EvaluationTerms terms;
+};
+
+// Everything that makes up a position, independent of the party to move. BoardView interprets it for one party.
+struct Position {
     std::array<std::uint64_t, 16> figures;
     std::array<bool, 4> castling{true, true, true, true};
     std::uint64_t enPassent = 0ul;
+    // position key over pieces, castling and en passent, updated by makeMove. The side to move is added by getHash().
+    std::uint64_t hash = 0ul;
+    // piece on each square, kept in sync with figures. Stored as bytes so it fits into one cache line.
+    std::array<std::uint8_t, 64> mailbox;
+    // material, piece-square and game phase terms of the evaluation, updated by makeMove
+    EvaluationTerms terms;
+};
+
+template <bool amIWhite>
+struct Board;
+
+// A position from the point of view of one party, without owning it. Cheap to copy and to flip over to the other
+// party, so the search makes and unmakes the moves of both parties on a single Position.
+template <bool amIWhite>
+struct BoardView {
+    Position& position;
+
+    explicit BoardView(Position& newPosition)
+        : position(newPosition) {}
 
     constexpr const static piece OwnKing = amIWhite ? WhiteKing : BlackKing;
     constexpr const static piece OwnQueen = amIWhite ? WhiteQueen : BlackQueen;
@@ -55,27 +118,31 @@ struct Board {
         }
     }
 
-    Board();
-    template <bool hasBeenWhite>
-    Board(Board<hasBeenWhite>&& previous);
-    template <bool hasBeenWhite>
-    Board(const Board<hasBeenWhite>& previous);
-    template <bool hasBeenWhite>
-    constexpr Board<amIWhite>& operator=(Board<hasBeenWhite>&& previous);
-    template <bool hasBeenWhite>
-    constexpr Board<amIWhite>& operator=(const Board<hasBeenWhite>& previous);
-
-    Board(std::string input);
     void initEmptyField();
 
     piece at(std::uint64_t pos) const;
 
     void fillCaches();
+    void fillMailbox();
+    void fillZobrist();
+    void fillTerms();
+    constexpr std::uint64_t getHash() const {
+        return amIWhite ? position.hash : position.hash ^ zobrist::keys.blackToMove;
+    }
     bool isCacheCoherent() const;
 
     bool isValid() const;
     bool isValidMove(Move move) const;
+    bool isLegalMove(Move move, MoveMask mask) const;
+    bool isQuiet(Move move) const;
     Board<amIWhite> applyMove(Move move) const;
+    MoveUndo makeMove(Move move);
+    void unmakeMove(Move move, const MoveUndo& undo);
+    MoveUndo makeNullMove();
+    void unmakeNullMove(const MoveUndo& undo);
+    // the same position from the point of view of the other party, for continuing after makeMove
+    BoardView<!amIWhite> flipped() const { return BoardView<!amIWhite>{position}; }
+    Move unpackMove(PackedMove move) const;
 
     piece figureAt(std::uint64_t pos) const;
 
@@ -85,20 +152,42 @@ struct Board {
     template <class F>
     constexpr void forEachKingMove(F&& func) const;
     template <class F>
-    constexpr void forEachQueenMove(F&& func) const;
+    constexpr void forEachKingMove(F&& func, const MoveMask& mask) const;
     template <class F>
-    constexpr void forEachRookMove(F&& func) const;
+    constexpr void forEachQueenMove(F&& func, const MoveMask& mask = MoveMask{}) const;
     template <class F>
-    constexpr void forEachBishopMove(F&& func) const;
+    constexpr void forEachRookMove(F&& func, const MoveMask& mask = MoveMask{}) const;
     template <class F>
-    constexpr void forEachKnightMove(F&& func) const;
+    constexpr void forEachBishopMove(F&& func, const MoveMask& mask = MoveMask{}) const;
     template <class F>
-    constexpr void forEachPawnMove(F&& func) const;
+    constexpr void forEachKnightMove(F&& func, const MoveMask& mask = MoveMask{}) const;
+    template <class F>
+    constexpr void forEachPawnMove(F&& func, const MoveMask& mask = MoveMask{}) const;
+
+    MoveMask getPseudoLegalMask() const;
+    MoveMask getLegalMask() const;
 
     Move getFirstValidMove() const;
+    Move getFirstLegalMove() const;
 
+    template <class F>
+    void forEachMaskedMove(F&& func, const MoveMask& mask) const;
     template <class F>
     void forEachValidMove(F&& func) const;
+    Mobility getMobility() const;
+    constexpr std::uint64_t getCastlingTargets(std::uint64_t threatened) const;
+    template <class F>
+    void forEachLegalMove(F&& func) const;
+
+    template <piece fig>
+    constexpr std::uint64_t getFigureAttacks() const;
+    template <bool ofWhite>
+    constexpr std::uint64_t getSideAttacks() const;
+    template <bool ofWhite>
+    constexpr std::uint64_t getSideAttacks(std::uint64_t obstacles) const;
+    constexpr std::uint64_t getThreatenedFields() const;
+    constexpr std::uint64_t getCheckers() const;
+    constexpr bool isInCheck() const;
 
     template <piece fig>
     constexpr bool isThreatenedByFigure(std::uint64_t positions) const;
@@ -107,58 +196,72 @@ struct Board {
     constexpr bool isThreatenedDebugVariant(std::uint64_t positions) const;
 };
 
+// Owns its position, for keeping boards around. Copies and conversions between the parties copy the position.
+template <bool amIWhite>
+struct Board : Position, BoardView<amIWhite> {
+    Board();
+    Board(std::string input);
+    Board(const Board<amIWhite>& previous)
+        : Position(previous)
+        , BoardView<amIWhite>(static_cast<Position&>(*this)) {}
+    template <bool hasBeenWhite>
+    Board(const BoardView<hasBeenWhite>& previous)
+        : Position(previous.position)
+        , BoardView<amIWhite>(static_cast<Position&>(*this)) {}
+
+    Board<amIWhite>& operator=(const Board<amIWhite>& previous) {
+        static_cast<Position&>(*this) = previous;
+        return *this;
+    }
+    template <bool hasBeenWhite>
+    Board<amIWhite>& operator=(const BoardView<hasBeenWhite>& previous) {
+        static_cast<Position&>(*this) = previous.position;
+        return *this;
+    }
+
+    // The position as raw bytes, for the move caches in files. The view only refers to it and is not written.
+    void write(std::ostream& out) const;
+    void read(std::istream& in);
+};
+
+template <bool amIWhite>
+void Board<amIWhite>::write(std::ostream& out) const {
+    static_assert(std::is_trivially_copyable_v<Position>);
+    out.write(reinterpret_cast<const char*>(static_cast<const Position*>(this)), sizeof(Position));
+}
+
+template <bool amIWhite>
+void Board<amIWhite>::read(std::istream& in) {
+    static_assert(std::is_trivially_copyable_v<Position>);
+    in.read(reinterpret_cast<char*>(static_cast<Position*>(this)), sizeof(Position));
+}
+
+// Orders by the zobrist hash first, the full comparison only runs for equal keys.
 template <bool amIWhite1, bool amIWhite2>
 bool operator<(const Board<amIWhite1>& board1, const Board<amIWhite2>& board2) {
+    if (board1.hash != board2.hash) {
+        return board1.hash < board2.hash;
+    }
     return board1.figures < board2.figures || (board1.figures == board2.figures && board1.castling < board2.castling) ||
         (board1.figures == board2.figures && board1.castling == board2.castling && board1.enPassent < board2.enPassent);
 }
 
 template <bool amIWhite>
 bool operator==(const Board<amIWhite>& board1, const Board<amIWhite>& board2) {
-    return board1.figures == board2.figures && board1.castling == board2.castling &&
-        board1.enPassent == board2.enPassent;
+    return board1.hash == board2.hash && board1.figures == board2.figures &&
+        board1.castling == board2.castling && board1.enPassent == board2.enPassent;
 }
 constexpr std::uint64_t getDirectionSize(const std::uint64_t pos, const char direction);
 
 template <bool amIWhite>
-Board<amIWhite>::Board() {
+Board<amIWhite>::Board()
+    : BoardView<amIWhite>(static_cast<Position&>(*this)) {
     this->initEmptyField();
 }
 
 template <bool amIWhite>
-template <bool hasBeenWhite>
-Board<amIWhite>::Board(Board<hasBeenWhite>&& previous)
-    : figures(previous.figures)
-    , castling(previous.castling)
-    , enPassent(previous.enPassent) {}
-
-template <bool amIWhite>
-template <bool hasBeenWhite>
-Board<amIWhite>::Board(const Board<hasBeenWhite>& previous)
-    : figures(previous.figures)
-    , castling(previous.castling)
-    , enPassent(previous.enPassent) {}
-
-template <bool amIWhite>
-template <bool hasBeenWhite>
-constexpr Board<amIWhite>& Board<amIWhite>::operator=(Board<hasBeenWhite>&& previous) {
-    figures = previous.figures;
-    castling = previous.castling;
-    enPassent = previous.enPassent;
-    return *this;
-}
-
-template <bool amIWhite>
-template <bool hasBeenWhite>
-constexpr Board<amIWhite>& Board<amIWhite>::operator=(const Board<hasBeenWhite>& previous) {
-    figures = previous.figures;
-    castling = previous.castling;
-    enPassent = previous.enPassent;
-    return *this;
-}
-
-template <bool amIWhite>
-Board<amIWhite>::Board(std::string input) {
+Board<amIWhite>::Board(std::string input)
+    : BoardView<amIWhite>(static_cast<Position&>(*this)) {
     for (auto& it : figures) {
         it = 0;
     }
@@ -216,34 +319,40 @@ Board<amIWhite>::Board(std::string input) {
     if (!(figures[BlackRook] & 0b10000000ul)) {
         castling[3] = false;
     }
-    fillCaches();
+    this->fillCaches();
+    this->fillMailbox();
+    this->fillZobrist();
+    this->fillTerms();
 }
 
 template <bool amIWhite>
-void Board<amIWhite>::initEmptyField() {
-    figures[WhiteKing] = whiteKingStartPos;
-    figures[WhiteQueen] = whiteQueenStartPos;
-    figures[WhiteRook] = whiteRookStartPos;
-    figures[WhiteBishop] = whiteBishopStartPos;
-    figures[WhiteKnight] = whiteKnightStartPos;
-    figures[WhitePawn] = whitePawnStartPos;
-    figures[BlackKing] = blackKingStartPos;
-    figures[BlackQueen] = blackQueenStartPos;
-    figures[BlackRook] = blackRookStartPos;
-    figures[BlackBishop] = blackBishopStartPos;
-    figures[BlackKnight] = blackKnightStartPos;
-    figures[BlackPawn] = blackPawnStartPos;
+void BoardView<amIWhite>::initEmptyField() {
+    position.figures[WhiteKing] = whiteKingStartPos;
+    position.figures[WhiteQueen] = whiteQueenStartPos;
+    position.figures[WhiteRook] = whiteRookStartPos;
+    position.figures[WhiteBishop] = whiteBishopStartPos;
+    position.figures[WhiteKnight] = whiteKnightStartPos;
+    position.figures[WhitePawn] = whitePawnStartPos;
+    position.figures[BlackKing] = blackKingStartPos;
+    position.figures[BlackQueen] = blackQueenStartPos;
+    position.figures[BlackRook] = blackRookStartPos;
+    position.figures[BlackBishop] = blackBishopStartPos;
+    position.figures[BlackKnight] = blackKnightStartPos;
+    position.figures[BlackPawn] = blackPawnStartPos;
     fillCaches();
+    fillMailbox();
+    fillZobrist();
+    fillTerms();
 }
 
 template <bool amIWhite>
-piece Board<amIWhite>::at(std::uint64_t pos) const {
-    auto result = std::find_if(figures.begin(), figures.end(), [&](auto fig) { return fig & pos; });
-    return static_cast<piece>(result - figures.begin()); // returns AnyFigure if result == figures.end()
+piece BoardView<amIWhite>::at(std::uint64_t pos) const {
+    return figureAt(pos);
 }
 
 template <bool amIWhite>
-void Board<amIWhite>::fillCaches() {
+void BoardView<amIWhite>::fillCaches() {
+    auto& figures = position.figures;
     figures[OwnFigure] = figures[OwnKing] | figures[OwnQueen] | figures[OwnRook] | figures[OwnBishop] |
         figures[OwnKnight] | figures[OwnPawn];
     figures[EnemyFigure] = figures[EnemyKing] | figures[EnemyQueen] | figures[EnemyRook] | figures[EnemyBishop] |
@@ -253,7 +362,43 @@ void Board<amIWhite>::fillCaches() {
 }
 
 template <bool amIWhite>
-bool Board<amIWhite>::isCacheCoherent() const {
+void BoardView<amIWhite>::fillMailbox() {
+    position.mailbox.fill(None);
+    for (auto fig : {WhiteKing, WhiteQueen, WhiteRook, WhiteBishop, WhiteKnight, WhitePawn, BlackKing, BlackQueen,
+                     BlackRook, BlackBishop, BlackKnight, BlackPawn}) {
+        forEachPos(position.figures[fig], [&](std::uint64_t pos) {
+            position.mailbox[__builtin_ctzll(pos)] = fig;
+            return true;
+        });
+    }
+}
+
+template <bool amIWhite>
+void BoardView<amIWhite>::fillZobrist() {
+    position.hash = zobrist::enPassentKey(position.enPassent);
+    for (std::size_t i = 0; i < position.castling.size(); ++i) {
+        if (position.castling[i]) {
+            position.hash ^= zobrist::keys.castling[i];
+        }
+    }
+    for (std::size_t i = 0; i < position.mailbox.size(); ++i) {
+        position.hash ^= zobrist::keys.pieces[position.mailbox[i]][i];
+    }
+}
+
+template <bool amIWhite>
+void BoardView<amIWhite>::fillTerms() {
+    position.terms = EvaluationTerms{};
+    for (std::size_t i = 0; i < position.mailbox.size(); ++i) {
+        if (position.mailbox[i] != None) {
+            position.terms.add(static_cast<piece>(position.mailbox[i]), 1ul << i);
+        }
+    }
+}
+
+template <bool amIWhite>
+bool BoardView<amIWhite>::isCacheCoherent() const {
+    const auto& figures = position.figures;
     return figures[OwnFigure] ==
         (figures[OwnKing] | figures[OwnQueen] | figures[OwnRook] | figures[OwnBishop] | figures[OwnKnight] |
          figures[OwnPawn]) &&
@@ -265,55 +410,102 @@ bool Board<amIWhite>::isCacheCoherent() const {
 }
 
 template <bool amIWhite>
-bool Board<amIWhite>::isValid() const {
-    return figures[OwnKing] && figures[EnemyKing];
+bool BoardView<amIWhite>::isValid() const {
+    return position.figures[OwnKing] && position.figures[EnemyKing];
 }
 
 template <bool amIWhite>
-bool Board<amIWhite>::isValidMove(Move move) const {
+bool BoardView<amIWhite>::isValidMove(Move move) const {
+    const auto& figures = position.figures;
     return __builtin_popcountll(move.moveFrom) == 1 && __builtin_popcountll(move.moveTo) == 1 &&
         (move.moveFrom & figures[OwnFigure]) && (move.moveTo & ~figures[OwnFigure]) && isOwn(move.turnFrom) &&
         isOwn(move.turnTo);
 }
 
+// Checks a move from an unreliable source (e.g. a hash or killer move) by generating it.
+template <bool amIWhite>
+bool BoardView<amIWhite>::isLegalMove(Move move, MoveMask mask) const {
+    if (!isValidMove(move) || figureAt(move.moveFrom) != move.turnFrom) {
+        return false;
+    }
+    // en passent is masked by the square of the captured pawn
+    auto targets = move.moveTo;
+    if (isPawn(move.turnFrom) && move.moveTo == position.enPassent) {
+        targets |= amIWhite ? position.enPassent << 8 : position.enPassent >> 8;
+    }
+    mask.targets &= targets;
+    bool found = false;
+    auto func = [&](const Move& generated) {
+        found |= generated == move;
+        return true;
+    };
+    if (isKing(move.turnFrom)) {
+        forEachKingMove(func, mask);
+    }
+    else if (isQueen(move.turnFrom)) {
+        forEachQueenMove(func, mask);
+    }
+    else if (isRook(move.turnFrom)) {
+        forEachRookMove(func, mask);
+    }
+    else if (isBishop(move.turnFrom)) {
+        forEachBishopMove(func, mask);
+    }
+    else if (isKnight(move.turnFrom)) {
+        forEachKnightMove(func, mask);
+    }
+    else if (isPawn(move.turnFrom)) {
+        forEachPawnMove(func, mask);
+    }
+    return found;
+}
+
+// neither a capture, including en passent, nor a promotion. Has to be called before the move is made.
 template <bool amIWhite>
-void extensiveTests(const Board<amIWhite>& result) {
-    if (result.figures[result.OwnFigure] !=
-        (result.figures[result.OwnKing] | result.figures[result.OwnQueen] | result.figures[result.OwnRook] |
-         result.figures[result.OwnBishop] | result.figures[result.OwnKnight] | result.figures[result.OwnPawn])) {
+bool BoardView<amIWhite>::isQuiet(Move move) const {
+    return !(move.moveTo & position.figures[EnemyFigure]) && move.turnFrom == move.turnTo &&
+        !(isPawn(move.turnFrom) && move.moveTo == position.enPassent);
+}
+
+template <bool amIWhite>
+void extensiveTests(const BoardView<amIWhite>& result) {
+    const auto& figures = result.position.figures;
+    if (figures[result.OwnFigure] !=
+        (figures[result.OwnKing] | figures[result.OwnQueen] | figures[result.OwnRook] |
+         figures[result.OwnBishop] | figures[result.OwnKnight] | figures[result.OwnPawn])) {
         std::cout << "1\n" << result << std::endl;
     }
-    if (result.figures[result.EnemyFigure] !=
-        (result.figures[result.EnemyKing] | result.figures[result.EnemyQueen] | result.figures[result.EnemyRook] |
-         result.figures[result.EnemyBishop] | result.figures[result.EnemyKnight] | result.figures[result.EnemyPawn])) {
+    if (figures[result.EnemyFigure] !=
+        (figures[result.EnemyKing] | figures[result.EnemyQueen] | figures[result.EnemyRook] |
+         figures[result.EnemyBishop] | figures[result.EnemyKnight] | figures[result.EnemyPawn])) {
         std::cout << "2\n" << result << std::endl;
     }
-    if ((result.figures[result.OwnFigure] & result.figures[result.EnemyFigure]) != 0ul) {
+    if ((figures[result.OwnFigure] & figures[result.EnemyFigure]) != 0ul) {
         std::cout << "3\n" << result << std::endl;
     }
-    if (result.figures[AnyFigure] != (result.figures[result.OwnFigure] | result.figures[result.EnemyFigure])) {
+    if (figures[AnyFigure] != (figures[result.OwnFigure] | figures[result.EnemyFigure])) {
         std::cout << "4\n" << result << std::endl;
     }
-    if (result.figures[None] != ~result.figures[AnyFigure]) {
+    if (figures[None] != ~figures[AnyFigure]) {
         std::cout << "5\n" << result << std::endl;
     }
-    for (auto it : result.figures) {
+    for (auto it : figures) {
         for (std::uint64_t i = 1ul << 63; i != 0; i >>= 1) {
             std::cout << ((it & i) ? "1" : "0");
         }
         std::cout << " " << it << std::endl;
     }
-    auto it = result.figures[result.OwnFigure];
+    auto it = figures[result.OwnFigure];
     for (std::uint64_t i = 1ul << 63; i != 0; i >>= 1) {
         std::cout << ((it & i) ? "1" : "0");
     }
     std::cout << " " << it << std::endl;
-    it = result.figures[result.EnemyFigure];
+    it = figures[result.EnemyFigure];
     for (std::uint64_t i = 1ul << 63; i != 0; i >>= 1) {
         std::cout << ((it & i) ? "1" : "0");
     }
     std::cout << " " << it << std::endl;
-    it = (result.figures[result.OwnFigure] & result.figures[result.EnemyFigure]);
+    it = (figures[result.OwnFigure] & figures[result.EnemyFigure]);
     for (std::uint64_t i = 1ul << 63; i != 0; i >>= 1) {
         std::cout << ((it & i) ? "1" : "0");
     }
@@ -321,59 +513,76 @@ void extensiveTests(const Board<amIWhite>& result) {
 }
 
 template <bool amIWhite>
-Board<amIWhite> Board<amIWhite>::applyMove(Move move) const {
-    assert(isCacheCoherent());
+Board<amIWhite> BoardView<amIWhite>::applyMove(Move move) const {
     Board<amIWhite> result{*this};
-    result.enPassent = 0ul;
+    result.makeMove(move);
+    return result;
+}
+
+// Applies the move in place. Afterwards the board belongs to the other party, use flipped() to continue from there.
+template <bool amIWhite>
+MoveUndo BoardView<amIWhite>::makeMove(Move move) {
+    auto& [figures, castling, enPassent, hash, mailbox, terms] = position;
+    assert(isCacheCoherent());
+    MoveUndo undo{enPassent, castling, mailbox[__builtin_ctzll(move.moveTo)], hash, terms};
     auto tmp = isValidMove(move) &&
         ::isValidMove(move, figures[AnyFigure], castling[0], castling[1], castling[2], castling[3], enPassent);
     if (!tmp) {
         std::cout << "Trying to apply invalid move:\n" << *this << move << std::endl;
     }
     assert(tmp && "Cannot apply invalid move!");
-    result.figures[move.turnFrom] &= ~move.moveFrom;
-    result.figures[move.turnTo] |= move.moveTo;
-    result.figures[OwnFigure] &= ~move.moveFrom;
-    result.figures[OwnFigure] |= move.moveTo;
-    if (result.figures[EnemyFigure] & move.moveTo) {
-        result.figures[EnemyFigure] &= ~move.moveTo;
-        result.figures[EnemyKing] &= ~move.moveTo;
-        result.figures[EnemyQueen] &= ~move.moveTo;
-        result.figures[EnemyRook] &= ~move.moveTo;
-        result.figures[EnemyBishop] &= ~move.moveTo;
-        result.figures[EnemyKnight] &= ~move.moveTo;
-        result.figures[EnemyPawn] &= ~move.moveTo;
+    enPassent = 0ul;
+    figures[move.turnFrom] &= ~move.moveFrom;
+    figures[move.turnTo] |= move.moveTo;
+    mailbox[__builtin_ctzll(move.moveFrom)] = None;
+    mailbox[__builtin_ctzll(move.moveTo)] = move.turnTo;
+    figures[OwnFigure] &= ~move.moveFrom;
+    figures[OwnFigure] |= move.moveTo;
+    hash ^= zobrist::pieceKey(move.turnFrom, move.moveFrom) ^ zobrist::pieceKey(move.turnTo, move.moveTo);
+    terms.remove(move.turnFrom, move.moveFrom);
+    terms.add(move.turnTo, move.moveTo);
+    if (undo.captured != None) {
+        figures[EnemyFigure] &= ~move.moveTo;
+        figures[undo.captured] &= ~move.moveTo;
+        hash ^= zobrist::pieceKey(static_cast<piece>(undo.captured), move.moveTo);
+        terms.remove(static_cast<piece>(undo.captured), move.moveTo);
     }
     // TODO(mstaff): improve performance of this part - no need to check everytime
     if (isRook(move.turnFrom)) {
         if (move.moveFrom == castling1RookStart) {
-            result.castling[0] = false;
+            castling[0] = false;
         }
         else if (move.moveFrom == castling2RookStart) {
-            result.castling[1] = false;
+            castling[1] = false;
         }
         else if (move.moveFrom == castling3RookStart) {
-            result.castling[2] = false;
+            castling[2] = false;
         }
         else if (move.moveFrom == castling4RookStart) {
-            result.castling[3] = false;
+            castling[3] = false;
         }
     }
     else if (isPawn(move.turnFrom)) {
         if (move.moveFrom & whitePawnStartPos && move.moveTo & whitePawnJumpPos) {
-            result.enPassent = move.moveTo << 8;
+            enPassent = move.moveTo << 8;
         }
         else if (move.moveFrom & blackPawnStartPos && move.moveTo & blackPawnJumpPos) {
-            result.enPassent = move.moveFrom << 8;
+            enPassent = move.moveFrom << 8;
         }
-        else if (move.moveTo & enPassent) {
+        else if (move.moveTo & undo.enPassent) {
             if (move.moveFrom & whitePawnJumpPos) {
-                result.figures[EnemyPawn] &= ~(move.moveTo >> 8);
-                result.figures[EnemyFigure] &= ~(move.moveTo >> 8);
+                figures[EnemyPawn] &= ~(move.moveTo >> 8);
+                figures[EnemyFigure] &= ~(move.moveTo >> 8);
+                mailbox[__builtin_ctzll(move.moveTo >> 8)] = None;
+                hash ^= zobrist::pieceKey(EnemyPawn, move.moveTo >> 8);
+                terms.remove(EnemyPawn, move.moveTo >> 8);
             }
             else if (move.moveFrom & blackPawnJumpPos) {
-                result.figures[EnemyPawn] &= ~(move.moveTo << 8);
-                result.figures[EnemyFigure] &= ~(move.moveTo << 8);
+                figures[EnemyPawn] &= ~(move.moveTo << 8);
+                figures[EnemyFigure] &= ~(move.moveTo << 8);
+                mailbox[__builtin_ctzll(move.moveTo << 8)] = None;
+                hash ^= zobrist::pieceKey(EnemyPawn, move.moveTo << 8);
+                terms.remove(EnemyPawn, move.moveTo << 8);
             }
             else {
                 assert(false && "Malformed en passent - invalid move!");
@@ -385,228 +594,389 @@ Board<amIWhite> Board<amIWhite>::applyMove(Move move) const {
             if (move.moveFrom == whiteKingStartPos) {
                 if (move.moveTo == castling1Target) {
                     assert(
-                        castling[0] && (figures[WhiteRook] & castling1RookStart) == castling1RookStart &&
+                        undo.castling[0] && (figures[WhiteRook] & castling1RookStart) == castling1RookStart &&
                         (figures[None] & castling1Fields) == castling1Fields && "Castling is blocked!");
-                    result.figures[WhiteRook] &= ~castling1RookStart;
-                    result.figures[WhiteRook] |= castling1RookTarget;
-                    result.figures[WhiteFigure] &= ~castling1RookStart;
-                    result.figures[WhiteFigure] |= castling1RookTarget;
+                    figures[WhiteRook] &= ~castling1RookStart;
+                    figures[WhiteRook] |= castling1RookTarget;
+                    figures[WhiteFigure] &= ~castling1RookStart;
+                    figures[WhiteFigure] |= castling1RookTarget;
+                    mailbox[__builtin_ctzll(castling1RookStart)] = None;
+                    mailbox[__builtin_ctzll(castling1RookTarget)] = WhiteRook;
+                    hash ^= zobrist::pieceKey(WhiteRook, castling1RookStart) ^
+                        zobrist::pieceKey(WhiteRook, castling1RookTarget);
+                    terms.remove(WhiteRook, castling1RookStart);
+                    terms.add(WhiteRook, castling1RookTarget);
                 }
                 if (move.moveTo == castling2Target) {
                     assert(
-                        castling[1] && (figures[WhiteRook] & castling2RookStart) == castling2RookStart &&
+                        undo.castling[1] && (figures[WhiteRook] & castling2RookStart) == castling2RookStart &&
                         (figures[None] & castling2Fields) == castling2Fields && "Castling is blocked!");
-                    result.figures[WhiteRook] &= ~castling2RookStart;
-                    result.figures[WhiteRook] |= castling2RookTarget;
-                    result.figures[WhiteFigure] &= ~castling2RookStart;
-                    result.figures[WhiteFigure] |= castling2RookTarget;
+                    figures[WhiteRook] &= ~castling2RookStart;
+                    figures[WhiteRook] |= castling2RookTarget;
+                    figures[WhiteFigure] &= ~castling2RookStart;
+                    figures[WhiteFigure] |= castling2RookTarget;
+                    mailbox[__builtin_ctzll(castling2RookStart)] = None;
+                    mailbox[__builtin_ctzll(castling2RookTarget)] = WhiteRook;
+                    hash ^= zobrist::pieceKey(WhiteRook, castling2RookStart) ^
+                        zobrist::pieceKey(WhiteRook, castling2RookTarget);
+                    terms.remove(WhiteRook, castling2RookStart);
+                    terms.add(WhiteRook, castling2RookTarget);
                 }
             }
-            result.castling[0] = false;
-            result.castling[1] = false;
+            castling[0] = false;
+            castling[1] = false;
         }
         else if (move.turnFrom == BlackKing) {
             if (move.moveFrom == blackKingStartPos) {
                 if (move.moveTo == castling3Target) {
                     assert(
-                        castling[2] && (figures[BlackRook] & castling3RookStart) == castling3RookStart &&
+                        undo.castling[2] && (figures[BlackRook] & castling3RookStart) == castling3RookStart &&
                         (figures[None] & castling3Fields) == castling3Fields && "Castling is blocked!");
-                    result.figures[BlackRook] &= ~castling3RookStart;
-                    result.figures[BlackRook] |= castling3RookTarget;
-                    result.figures[BlackFigure] &= ~castling3RookStart;
-                    result.figures[BlackFigure] |= castling3RookTarget;
+                    figures[BlackRook] &= ~castling3RookStart;
+                    figures[BlackRook] |= castling3RookTarget;
+                    figures[BlackFigure] &= ~castling3RookStart;
+                    figures[BlackFigure] |= castling3RookTarget;
+                    mailbox[__builtin_ctzll(castling3RookStart)] = None;
+                    mailbox[__builtin_ctzll(castling3RookTarget)] = BlackRook;
+                    hash ^= zobrist::pieceKey(BlackRook, castling3RookStart) ^
+                        zobrist::pieceKey(BlackRook, castling3RookTarget);
+                    terms.remove(BlackRook, castling3RookStart);
+                    terms.add(BlackRook, castling3RookTarget);
                 }
                 if (move.moveTo == castling4Target) {
                     assert(
-                        castling[3] && (figures[BlackRook] & castling4RookStart) == castling4RookStart &&
+                        undo.castling[3] && (figures[BlackRook] & castling4RookStart) == castling4RookStart &&
                         (figures[None] & castling4Fields) == castling4Fields && "Castling is blocked!");
-                    result.figures[BlackRook] &= ~castling4RookStart;
-                    result.figures[BlackRook] |= castling4RookTarget;
-                    result.figures[BlackFigure] &= ~castling4RookStart;
-                    result.figures[BlackFigure] |= castling4RookTarget;
+                    figures[BlackRook] &= ~castling4RookStart;
+                    figures[BlackRook] |= castling4RookTarget;
+                    figures[BlackFigure] &= ~castling4RookStart;
+                    figures[BlackFigure] |= castling4RookTarget;
+                    mailbox[__builtin_ctzll(castling4RookStart)] = None;
+                    mailbox[__builtin_ctzll(castling4RookTarget)] = BlackRook;
+                    hash ^= zobrist::pieceKey(BlackRook, castling4RookStart) ^
+                        zobrist::pieceKey(BlackRook, castling4RookTarget);
+                    terms.remove(BlackRook, castling4RookStart);
+                    terms.add(BlackRook, castling4RookTarget);
                 }
             }
-            result.castling[2] = false;
-            result.castling[3] = false;
+            castling[2] = false;
+            castling[3] = false;
         }
     }
-    assert(isCacheCoherent());
-    result.figures[AnyFigure] = result.figures[OwnFigure] | result.figures[EnemyFigure];
-    result.figures[None] = ~result.figures[AnyFigure];
-    if (!result.isCacheCoherent()) {
+    hash ^= zobrist::enPassentKey(undo.enPassent) ^ zobrist::enPassentKey(enPassent);
+    for (std::size_t i = 0; i < castling.size(); ++i) {
+        if (castling[i] != undo.castling[i]) {
+            hash ^= zobrist::keys.castling[i];
+        }
+    }
+    figures[AnyFigure] = figures[OwnFigure] | figures[EnemyFigure];
+    figures[None] = ~figures[AnyFigure];
+    if (!isCacheCoherent()) {
         extensiveTests(*this);
-        extensiveTests(result);
     }
-    assert(result.isCacheCoherent());
-    return result;
+    assert(isCacheCoherent());
+    return undo;
 }
 
 template <bool amIWhite>
-piece Board<amIWhite>::figureAt(std::uint64_t pos) const {
-    assert(__builtin_popcountll(pos) == 1);
-    for (size_t i = 0; i < figures.size(); ++i) {
-        if (figures[i] & pos) {
-            return static_cast<piece>(i);
+void BoardView<amIWhite>::unmakeMove(Move move, const MoveUndo& undo) {
+    position.figures[move.turnTo] &= ~move.moveTo;
+    position.figures[move.turnFrom] |= move.moveFrom;
+    position.figures[OwnFigure] &= ~move.moveTo;
+    position.figures[OwnFigure] |= move.moveFrom;
+    position.mailbox[__builtin_ctzll(move.moveFrom)] = move.turnFrom;
+    position.mailbox[__builtin_ctzll(move.moveTo)] = undo.captured;
+    if (undo.captured != None) {
+        position.figures[undo.captured] |= move.moveTo;
+        position.figures[EnemyFigure] |= move.moveTo;
+    }
+    else if (isPawn(move.turnFrom) && (move.moveTo & undo.enPassent)) {
+        auto capturedPos = (move.moveFrom & whitePawnJumpPos) ? move.moveTo >> 8 : move.moveTo << 8;
+        position.figures[EnemyPawn] |= capturedPos;
+        position.figures[EnemyFigure] |= capturedPos;
+        position.mailbox[__builtin_ctzll(capturedPos)] = EnemyPawn;
+    }
+    else if (move.turnFrom == WhiteKing && move.moveFrom == whiteKingStartPos) {
+        if (move.moveTo == castling1Target) {
+            position.figures[WhiteRook] = (position.figures[WhiteRook] & ~castling1RookTarget) | castling1RookStart;
+            position.figures[WhiteFigure] = (position.figures[WhiteFigure] & ~castling1RookTarget) | castling1RookStart;
+            position.mailbox[__builtin_ctzll(castling1RookTarget)] = None;
+            position.mailbox[__builtin_ctzll(castling1RookStart)] = WhiteRook;
+        }
+        else if (move.moveTo == castling2Target) {
+            position.figures[WhiteRook] = (position.figures[WhiteRook] & ~castling2RookTarget) | castling2RookStart;
+            position.figures[WhiteFigure] = (position.figures[WhiteFigure] & ~castling2RookTarget) | castling2RookStart;
+            position.mailbox[__builtin_ctzll(castling2RookTarget)] = None;
+            position.mailbox[__builtin_ctzll(castling2RookStart)] = WhiteRook;
         }
     }
-    return None;
+    else if (move.turnFrom == BlackKing && move.moveFrom == blackKingStartPos) {
+        if (move.moveTo == castling3Target) {
+            position.figures[BlackRook] = (position.figures[BlackRook] & ~castling3RookTarget) | castling3RookStart;
+            position.figures[BlackFigure] = (position.figures[BlackFigure] & ~castling3RookTarget) | castling3RookStart;
+            position.mailbox[__builtin_ctzll(castling3RookTarget)] = None;
+            position.mailbox[__builtin_ctzll(castling3RookStart)] = BlackRook;
+        }
+        else if (move.moveTo == castling4Target) {
+            position.figures[BlackRook] = (position.figures[BlackRook] & ~castling4RookTarget) | castling4RookStart;
+            position.figures[BlackFigure] = (position.figures[BlackFigure] & ~castling4RookTarget) | castling4RookStart;
+            position.mailbox[__builtin_ctzll(castling4RookTarget)] = None;
+            position.mailbox[__builtin_ctzll(castling4RookStart)] = BlackRook;
+        }
+    }
+    position.castling = undo.castling;
+    position.enPassent = undo.enPassent;
+    position.hash = undo.hash;
+    position.terms = undo.terms;
+    position.figures[AnyFigure] = position.figures[OwnFigure] | position.figures[EnemyFigure];
+    position.figures[None] = ~position.figures[AnyFigure];
+    assert(isCacheCoherent());
+}
+
+// Passes the turn to the other party without moving, only a possible en passent capture is lost.
+template <bool amIWhite>
+MoveUndo BoardView<amIWhite>::makeNullMove() {
+    MoveUndo undo{position.enPassent, position.castling, None, position.hash, position.terms};
+    position.hash ^= zobrist::enPassentKey(position.enPassent);
+    position.enPassent = 0ul;
+    return undo;
+}
+
+template <bool amIWhite>
+void BoardView<amIWhite>::unmakeNullMove(const MoveUndo& undo) {
+    position.enPassent = undo.enPassent;
+    position.hash = undo.hash;
+}
+
+template <bool amIWhite>
+piece BoardView<amIWhite>::figureAt(std::uint64_t pos) const {
+    assert(__builtin_popcountll(pos) == 1);
+    return static_cast<piece>(position.mailbox[__builtin_ctzll(pos)]);
+}
+
+template <bool amIWhite>
+Move BoardView<amIWhite>::unpackMove(PackedMove move) const {
+    if (move == PackedMove{}) {
+        return Move{};
+    }
+    std::uint64_t from = 1ul << move.from();
+    piece turnFrom = figureAt(from);
+    piece turnTo = move.isPromotion() ? static_cast<piece>(OwnQueen + move.promotion()) : turnFrom;
+    return Move{from, 1ul << move.to(), turnFrom, turnTo};
 }
 
 template <bool amIWhite>
 template <class F>
-constexpr void Board<amIWhite>::forEachKingMove(F&& func) const {
-    forEachPos(figures[OwnKing], [&](std::uint64_t currentPos) {
-        checkedMove<N, 1>(currentPos, OwnKing, OwnKing, func);
-        checkedMove<NE, 1>(currentPos, OwnKing, OwnKing, func);
-        checkedMove<E, 1>(currentPos, OwnKing, OwnKing, func);
-        checkedMove<SE, 1>(currentPos, OwnKing, OwnKing, func);
-        checkedMove<S, 1>(currentPos, OwnKing, OwnKing, func);
-        checkedMove<SW, 1>(currentPos, OwnKing, OwnKing, func);
-        checkedMove<W, 1>(currentPos, OwnKing, OwnKing, func);
-        checkedMove<NW, 1>(currentPos, OwnKing, OwnKing, func);
-        if constexpr (amIWhite) {
-            if (currentPos == whiteKingStartPos) {
-                if (castling[0] && (figures[OwnRook] & castling1RookStart) == castling1RookStart &&
-                    (figures[None] & castling1Fields) == castling1Fields &&
-                    !isThreatened(currentPos | castling1RookTarget | castling1Target)) {
-                    checkedMove<EE, 1>(currentPos, OwnKing, OwnKing, func);
-                }
-                if (castling[1] && (figures[OwnRook] & castling2RookStart) == castling2RookStart &&
-                    (figures[None] & castling2Fields) == castling2Fields &&
-                    !isThreatened(currentPos | castling2RookTarget | castling2Target)) {
-                    checkedMove<WW, 1>(currentPos, OwnKing, OwnKing, func);
-                }
+constexpr void BoardView<amIWhite>::forEachKingMove(F&& func) const {
+    forEachKingMove(std::forward<F>(func), getPseudoLegalMask());
+}
+
+template <bool amIWhite>
+template <class F>
+constexpr void BoardView<amIWhite>::forEachKingMove(F&& func, const MoveMask& mask) const {
+    const auto threatened = mask.threatened;
+    forEachPos(position.figures[OwnKing], [&](std::uint64_t currentPos) {
+        forEachMove(
+            currentPos,
+            attacks::kingTable[__builtin_ctzll(currentPos)] & ~position.figures[OwnFigure] & ~threatened & mask.targets,
+            OwnKing,
+            OwnKing,
+            func);
+        if (currentPos == (amIWhite ? whiteKingStartPos : blackKingStartPos)) {
+            const auto castlingTargets = getCastlingTargets(threatened) & mask.targets;
+            if (castlingTargets & (amIWhite ? castling1Target : castling3Target)) {
+                checkedMove<EE, 1>(currentPos, OwnKing, OwnKing, func);
             }
-        }
-        else {
-            if (currentPos == blackKingStartPos) {
-                if (castling[2] && (figures[OwnRook] & castling3RookStart) == castling3RookStart &&
-                    (figures[None] & castling3Fields) == castling3Fields &&
-                    !isThreatened(currentPos | castling3RookTarget | castling3Target)) {
-                    checkedMove<EE, 1>(currentPos, OwnKing, OwnKing, func);
-                }
-                if (castling[3] && (figures[OwnRook] & castling4RookStart) == castling4RookStart &&
-                    (figures[None] & castling4Fields) == castling4Fields &&
-                    !isThreatened(currentPos | castling4RookTarget | castling4Target)) {
-                    checkedMove<WW, 1>(currentPos, OwnKing, OwnKing, func);
-                }
+            if (castlingTargets & (amIWhite ? castling2Target : castling4Target)) {
+                checkedMove<WW, 1>(currentPos, OwnKing, OwnKing, func);
             }
         }
         return true;
     });
 }
 
+// Targets of the king for every castling that is still allowed, not blocked and doesn't cross a threatened field.
+template <bool amIWhite>
+constexpr std::uint64_t BoardView<amIWhite>::getCastlingTargets(std::uint64_t threatened) const {
+    const auto& figures = position.figures;
+    std::uint64_t result{0ul};
+    auto check = [&](bool allowed, std::uint64_t kingStart, std::uint64_t rookStart, std::uint64_t fields,
+                     std::uint64_t rookTarget, std::uint64_t target) {
+        if (allowed && (figures[OwnKing] & kingStart) && (figures[OwnRook] & rookStart) == rookStart &&
+            (figures[None] & fields) == fields && !(threatened & (kingStart | rookTarget | target))) {
+            result |= target;
+        }
+    };
+    if constexpr (amIWhite) {
+        check(position.castling[0], whiteKingStartPos, castling1RookStart, castling1Fields, castling1RookTarget,
+              castling1Target);
+        check(position.castling[1], whiteKingStartPos, castling2RookStart, castling2Fields, castling2RookTarget,
+              castling2Target);
+    }
+    else {
+        check(position.castling[2], blackKingStartPos, castling3RookStart, castling3Fields, castling3RookTarget,
+              castling3Target);
+        check(position.castling[3], blackKingStartPos, castling4RookStart, castling4Fields, castling4RookTarget,
+              castling4Target);
+    }
+    return result;
+}
+
 template <bool amIWhite>
 template <class F>
-constexpr void Board<amIWhite>::forEachQueenMove(F&& func) const {
+constexpr void BoardView<amIWhite>::forEachQueenMove(F&& func, const MoveMask& mask) const {
+    const auto& figures = position.figures;
     forEachPos(figures[OwnQueen], [&](std::uint64_t currentPos) {
-        checkedMoveUntil<N, 8>(currentPos, OwnQueen, OwnQueen, func);
-        checkedMoveUntil<E, 8>(currentPos, OwnQueen, OwnQueen, func);
-        checkedMoveUntil<S, 8>(currentPos, OwnQueen, OwnQueen, func);
-        checkedMoveUntil<W, 8>(currentPos, OwnQueen, OwnQueen, func);
-        checkedMoveUntil<NE, 8>(currentPos, OwnQueen, OwnQueen, func);
-        checkedMoveUntil<SE, 8>(currentPos, OwnQueen, OwnQueen, func);
-        checkedMoveUntil<SW, 8>(currentPos, OwnQueen, OwnQueen, func);
-        checkedMoveUntil<NW, 8>(currentPos, OwnQueen, OwnQueen, func);
+        auto targets = attacks::queenAttacks(__builtin_ctzll(currentPos), figures[AnyFigure]);
+        forEachMove(currentPos, targets & ~figures[OwnFigure] & mask.getTargets(currentPos), OwnQueen, OwnQueen, func);
         return true;
     });
 }
 
 template <bool amIWhite>
 template <class F>
-constexpr void Board<amIWhite>::forEachRookMove(F&& func) const {
+constexpr void BoardView<amIWhite>::forEachRookMove(F&& func, const MoveMask& mask) const {
+    const auto& figures = position.figures;
     forEachPos(figures[OwnRook], [&](std::uint64_t currentPos) {
-        checkedMoveUntil<N, 8>(currentPos, OwnRook, OwnRook, func);
-        checkedMoveUntil<E, 8>(currentPos, OwnRook, OwnRook, func);
-        checkedMoveUntil<S, 8>(currentPos, OwnRook, OwnRook, func);
-        checkedMoveUntil<W, 8>(currentPos, OwnRook, OwnRook, func);
+        auto targets = attacks::rookAttacks(__builtin_ctzll(currentPos), figures[AnyFigure]);
+        forEachMove(currentPos, targets & ~figures[OwnFigure] & mask.getTargets(currentPos), OwnRook, OwnRook, func);
         return true;
     });
 }
 
 template <bool amIWhite>
 template <class F>
-constexpr void Board<amIWhite>::forEachBishopMove(F&& func) const {
+constexpr void BoardView<amIWhite>::forEachBishopMove(F&& func, const MoveMask& mask) const {
+    const auto& figures = position.figures;
     forEachPos(figures[OwnBishop], [&](std::uint64_t currentPos) {
-        checkedMoveUntil<NE, 8>(currentPos, OwnBishop, OwnBishop, func);
-        checkedMoveUntil<SE, 8>(currentPos, OwnBishop, OwnBishop, func);
-        checkedMoveUntil<SW, 8>(currentPos, OwnBishop, OwnBishop, func);
-        checkedMoveUntil<NW, 8>(currentPos, OwnBishop, OwnBishop, func);
+        auto targets = attacks::bishopAttacks(__builtin_ctzll(currentPos), figures[AnyFigure]);
+        forEachMove(
+            currentPos, targets & ~figures[OwnFigure] & mask.getTargets(currentPos), OwnBishop, OwnBishop, func);
         return true;
     });
 }
 
 template <bool amIWhite>
 template <class F>
-constexpr void Board<amIWhite>::forEachKnightMove(F&& func) const {
+constexpr void BoardView<amIWhite>::forEachKnightMove(F&& func, const MoveMask& mask) const {
+    const auto& figures = position.figures;
     forEachPos(figures[OwnKnight], [&](std::uint64_t currentPos) {
-        checkedMove<NNE, 1>(currentPos, OwnKnight, OwnKnight, func);
-        checkedMove<ENE, 1>(currentPos, OwnKnight, OwnKnight, func);
-        checkedMove<ESE, 1>(currentPos, OwnKnight, OwnKnight, func);
-        checkedMove<SSE, 1>(currentPos, OwnKnight, OwnKnight, func);
-        checkedMove<SSW, 1>(currentPos, OwnKnight, OwnKnight, func);
-        checkedMove<WSW, 1>(currentPos, OwnKnight, OwnKnight, func);
-        checkedMove<WNW, 1>(currentPos, OwnKnight, OwnKnight, func);
-        checkedMove<NNW, 1>(currentPos, OwnKnight, OwnKnight, func);
+        forEachMove(
+            currentPos,
+            attacks::knightTable[__builtin_ctzll(currentPos)] & ~figures[OwnFigure] & mask.getTargets(currentPos),
+            OwnKnight,
+            OwnKnight,
+            func);
         return true;
     });
 }
 
+// All pawns are moved at once by shifting the whole pawn set, the origin of each target is found by shifting back.
 template <bool amIWhite>
 template <class F>
-constexpr void Board<amIWhite>::forEachPawnMove(F&& func) const {
-    auto moveFunc = [&](auto m) {
-        if (figures[None] & m.moveTo) {
-            func(m);
+constexpr void BoardView<amIWhite>::forEachPawnMove(F&& func, const MoveMask& mask) const {
+    const auto& figures = position.figures;
+    constexpr Direction forward = amIWhite ? N : S;
+    constexpr Direction jump = amIWhite ? NN : SS;
+    constexpr Direction takeEast = amIWhite ? NE : SE;
+    constexpr Direction takeWest = amIWhite ? NW : SW;
+    constexpr std::uint64_t promotionRank = amIWhite ? attacks::rank8 : attacks::rank1;
+    constexpr std::uint64_t jumpRank = amIWhite ? whitePawnJumpPos : blackPawnJumpPos;
+    const auto allowed = mask.evasions & mask.targets;
+    auto emit = [&](std::uint64_t targets, Direction dir) {
+        const auto distance = getIntDir(dir);
+        forEachPos(targets, [&](std::uint64_t to) {
+            const auto from = distance > 0 ? to << distance : to >> -distance;
+            // pinned pawns have to stay on their pin ray
+            if ((from & mask.pinned) && !(mask.getTargets(from) & to)) {
+                return true;
+            }
+            if (to & promotionRank) {
+                func(Move(from, to, OwnPawn, OwnQueen));
+                func(Move(from, to, OwnPawn, OwnRook));
+                func(Move(from, to, OwnPawn, OwnBishop));
+                func(Move(from, to, OwnPawn, OwnKnight));
+            }
+            else {
+                func(Move(from, to, OwnPawn, OwnPawn));
+            }
             return true;
-        }
-        return false;
+        });
     };
-    auto takeFunc = [&](auto m) {
-        if (figures[EnemyFigure] & m.moveTo || enPassent & m.moveTo) {
-            func(m);
+    const auto pushes = attacks::shift<forward>(figures[OwnPawn]) & figures[None];
+    emit(pushes & allowed, forward);
+    emit(attacks::shift<forward>(pushes) & jumpRank & figures[None] & allowed, jump);
+    emit(attacks::shift<takeEast>(figures[OwnPawn]) & figures[EnemyFigure] & allowed, takeEast);
+    emit(attacks::shift<takeWest>(figures[OwnPawn]) & figures[EnemyFigure] & allowed, takeWest);
+    // en passent is masked by the square of the captured pawn, its legality was checked by the mask already
+    if (position.enPassent && (mask.targets & (amIWhite ? position.enPassent << 8 : position.enPassent >> 8))) {
+        const auto capturers = attacks::pawnTable<!amIWhite>()[__builtin_ctzll(position.enPassent)] & figures[OwnPawn] &
+            mask.enPassentCapturers;
+        forEachPos(capturers, [&](std::uint64_t from) {
+            func(Move(from, position.enPassent, OwnPawn, OwnPawn));
             return true;
-        }
-        return false;
+        });
+    }
+}
+
+// Counts what forEachValidMove would hand out from the attack sets of every piece, without creating a single move.
+// Only the captures are looked up one by one, quiet moves are counted with a popcount.
+template <bool amIWhite>
+Mobility BoardView<amIWhite>::getMobility() const {
+    const auto& figures = position.figures;
+    constexpr Direction forward = amIWhite ? N : S;
+    constexpr Direction takeEast = amIWhite ? NE : SE;
+    constexpr Direction takeWest = amIWhite ? NW : SW;
+    constexpr std::uint64_t promotionRank = amIWhite ? attacks::rank8 : attacks::rank1;
+    constexpr std::uint64_t jumpRank = amIWhite ? whitePawnJumpPos : blackPawnJumpPos;
+    Mobility result;
+    auto add = [&](piece fig, std::uint64_t targets, int movesPerTarget) {
+        result.moves[fig] += __builtin_popcountll(targets) * movesPerTarget;
+        result.targets[None] += __builtin_popcountll(targets & figures[None]) * movesPerTarget;
+        forEachPos(targets & figures[EnemyFigure], [&](std::uint64_t pos) {
+            result.targets[position.mailbox[__builtin_ctzll(pos)]] += movesPerTarget;
+            return true;
+        });
     };
-    constexpr Direction moveDirection = amIWhite ? N : S;
-    constexpr Direction takeDirection1 = amIWhite ? NE : SE;
-    constexpr Direction takeDirection2 = amIWhite ? NW : SW;
-    forEachPos(figures[OwnPawn], [&](std::uint64_t currentPos) {
-        if (isInitialPawnPosition<amIWhite>(currentPos)) {
-            if (checkedMove<moveDirection, 1>(currentPos, OwnPawn, OwnPawn, moveFunc)) {
-                checkedMove<moveDirection, 2>(currentPos, OwnPawn, OwnPawn, moveFunc);
-            }
-        }
-        else if (isInitialPawnPosition<!amIWhite>(currentPos)) {
-            checkedMove<moveDirection, 1>(currentPos, OwnPawn, OwnQueen, moveFunc);
-            checkedMove<moveDirection, 1>(currentPos, OwnPawn, OwnRook, moveFunc);
-            checkedMove<moveDirection, 1>(currentPos, OwnPawn, OwnBishop, moveFunc);
-            checkedMove<moveDirection, 1>(currentPos, OwnPawn, OwnKnight, moveFunc);
-        }
-        else {
-            checkedMove<moveDirection, 1>(currentPos, OwnPawn, OwnPawn, moveFunc);
-        }
-        if (isInitialPawnPosition<!amIWhite>(currentPos)) {
-            checkedMove<takeDirection1, 1>(currentPos, OwnPawn, OwnQueen, takeFunc);
-            checkedMove<takeDirection1, 1>(currentPos, OwnPawn, OwnRook, takeFunc);
-            checkedMove<takeDirection1, 1>(currentPos, OwnPawn, OwnBishop, takeFunc);
-            checkedMove<takeDirection1, 1>(currentPos, OwnPawn, OwnKnight, takeFunc);
-            checkedMove<takeDirection2, 1>(currentPos, OwnPawn, OwnQueen, takeFunc);
-            checkedMove<takeDirection2, 1>(currentPos, OwnPawn, OwnRook, takeFunc);
-            checkedMove<takeDirection2, 1>(currentPos, OwnPawn, OwnBishop, takeFunc);
-            checkedMove<takeDirection2, 1>(currentPos, OwnPawn, OwnKnight, takeFunc);
-        }
-        else {
-            checkedMove<takeDirection1, 1>(currentPos, OwnPawn, OwnPawn, takeFunc);
-            checkedMove<takeDirection2, 1>(currentPos, OwnPawn, OwnPawn, takeFunc);
-        }
+    const auto pushes = attacks::shift<forward>(figures[OwnPawn]) & figures[None];
+    for (auto targets : {pushes, attacks::shift<takeEast>(figures[OwnPawn]) & figures[EnemyFigure],
+                         attacks::shift<takeWest>(figures[OwnPawn]) & figures[EnemyFigure]}) {
+        add(OwnPawn, targets & ~promotionRank, 1);
+        add(OwnPawn, targets & promotionRank, 4);
+    }
+    add(OwnPawn, attacks::shift<forward>(pushes) & jumpRank & figures[None], 1);
+    if (position.enPassent) {
+        const auto capturers = attacks::pawnTable<!amIWhite>()[__builtin_ctzll(position.enPassent)] & figures[OwnPawn];
+        result.moves[OwnPawn] += __builtin_popcountll(capturers);
+        result.targets[None] += __builtin_popcountll(capturers);
+    }
+    forEachPos(figures[OwnKnight], [&](std::uint64_t pos) {
+        add(OwnKnight, attacks::knightTable[__builtin_ctzll(pos)] & ~figures[OwnFigure], 1);
+        return true;
+    });
+    forEachPos(figures[OwnBishop], [&](std::uint64_t pos) {
+        add(OwnBishop, attacks::bishopAttacks(__builtin_ctzll(pos), figures[AnyFigure]) & ~figures[OwnFigure], 1);
+        return true;
+    });
+    forEachPos(figures[OwnRook], [&](std::uint64_t pos) {
+        add(OwnRook, attacks::rookAttacks(__builtin_ctzll(pos), figures[AnyFigure]) & ~figures[OwnFigure], 1);
         return true;
     });
+    forEachPos(figures[OwnQueen], [&](std::uint64_t pos) {
+        add(OwnQueen, attacks::queenAttacks(__builtin_ctzll(pos), figures[AnyFigure]) & ~figures[OwnFigure], 1);
+        return true;
+    });
+    const auto threatened = getThreatenedFields();
+    forEachPos(figures[OwnKing], [&](std::uint64_t pos) {
+        add(OwnKing, attacks::kingTable[__builtin_ctzll(pos)] & ~figures[OwnFigure] & ~threatened, 1);
+        return true;
+    });
+    add(OwnKing, getCastlingTargets(threatened), 1);
+    return result;
 }
 
 template <bool amIWhite>
-std::string Board<amIWhite>::print() const {
+std::string BoardView<amIWhite>::print() const {
     std::ostringstream tmp;
     tmp << " abcdefgh \n";
     for (auto i = 0; i < 64; ++i) {
@@ -619,45 +989,7 @@ std::string Board<amIWhite>::print() const {
         else {
             tmp << "\033[1;40m\033[1;37m";
         }
-        if (figures[WhiteKing] & (1ul << i)) {
-            tmp << "K";
-        }
-        else if (figures[WhiteQueen] & (1ul << i)) {
-            tmp << "Q";
-        }
-        else if (figures[WhiteRook] & (1ul << i)) {
-            tmp << "R";
-        }
-        else if (figures[WhiteBishop] & (1ul << i)) {
-            tmp << "B";
-        }
-        else if (figures[WhiteKnight] & (1ul << i)) {
-            tmp << "N";
-        }
-        else if (figures[WhitePawn] & (1ul << i)) {
-            tmp << "P";
-        }
-        else if (figures[BlackKing] & (1ul << i)) {
-            tmp << "k";
-        }
-        else if (figures[BlackQueen] & (1ul << i)) {
-            tmp << "q";
-        }
-        else if (figures[BlackRook] & (1ul << i)) {
-            tmp << "r";
-        }
-        else if (figures[BlackBishop] & (1ul << i)) {
-            tmp << "b";
-        }
-        else if (figures[BlackKnight] & (1ul << i)) {
-            tmp << "n";
-        }
-        else if (figures[BlackPawn] & (1ul << i)) {
-            tmp << "p";
-        }
-        else {
-            tmp << " ";
-        }
+        tmp << getChessChar(figureAt(1ul << i));
         if (i % 8 == 7) {
             tmp << "\033[0m" << 8 - i / 8 << "\n";
         }
@@ -667,48 +999,15 @@ std::string Board<amIWhite>::print() const {
 }
 
 template <bool amIWhite>
-std::string Board<amIWhite>::store() const {
+std::string BoardView<amIWhite>::store() const {
     std::ostringstream tmp;
     for (auto i = 0; i < 64; ++i) {
-        if (figures[WhiteKing] & (1ul << i)) {
-            tmp << "K";
-        }
-        else if (figures[WhiteQueen] & (1ul << i)) {
-            tmp << "Q";
-        }
-        else if (figures[WhiteRook] & (1ul << i)) {
-            tmp << "R";
-        }
-        else if (figures[WhiteBishop] & (1ul << i)) {
-            tmp << "B";
-        }
-        else if (figures[WhiteKnight] & (1ul << i)) {
-            tmp << "N";
-        }
-        else if (figures[WhitePawn] & (1ul << i)) {
-            tmp << "P";
-        }
-        else if (figures[BlackKing] & (1ul << i)) {
-            tmp << "k";
-        }
-        else if (figures[BlackQueen] & (1ul << i)) {
-            tmp << "q";
-        }
-        else if (figures[BlackRook] & (1ul << i)) {
-            tmp << "r";
-        }
-        else if (figures[BlackBishop] & (1ul << i)) {
-            tmp << "b";
-        }
-        else if (figures[BlackKnight] & (1ul << i)) {
-            tmp << "n";
-        }
-        else if (figures[BlackPawn] & (1ul << i)) {
-            tmp << "p";
+        if (position.mailbox[i] != None) {
+            tmp << getChessChar(figureAt(1ul << i));
         }
         else {
             int counter = 0;
-            while ((figures[None] & (1ul << i)) && i < 64) {
+            while (i < 64 && position.mailbox[i] == None) {
                 if (i % 8 == 0 && counter > 0) {
                     tmp << counter << "/";
                     counter = 0;
@@ -727,14 +1026,14 @@ std::string Board<amIWhite>::store() const {
 }
 
 template <bool amIWhite>
-std::ostream& operator<<(std::ostream& stream, const Board<amIWhite>& board) {
+std::ostream& operator<<(std::ostream& stream, const BoardView<amIWhite>& board) {
     stream << board.print();
     return stream;
 }
 
 // TODO(mstaff): refactor this function
 template <bool amIWhite>
-Move Board<amIWhite>::getFirstValidMove() const {
+Move BoardView<amIWhite>::getFirstValidMove() const {
     Move result{};
     bool taken{false};
     auto func = [&](auto m) {
@@ -749,87 +1048,202 @@ Move Board<amIWhite>::getFirstValidMove() const {
 }
 
 template <bool amIWhite>
-template <class F>
-void Board<amIWhite>::forEachValidMove(F&& func) const {
-    auto conditionalFunc = [&](auto m) {
-        if (figures[None] & m.moveTo) {
-            func(m);
-            return true;
-        }
-        else if (figures[EnemyFigure] & m.moveTo) {
-            if (figures[OwnFigure] & m.moveTo) {
-                assert(false && "Memory error.");
-            }
-            func(m);
-            return false;
-        }
-        else if (figures[OwnFigure] & m.moveTo) {
-            return false;
+Move BoardView<amIWhite>::getFirstLegalMove() const {
+    Move result{};
+    bool taken{false};
+    forEachLegalMove([&](auto m) {
+        if (!taken) {
+            result = m;
+            taken = true;
         }
-        else {
-            assert(false && "Memory error.");
-            return false;
+    });
+    return result;
+}
+
+template <bool amIWhite>
+MoveMask BoardView<amIWhite>::getPseudoLegalMask() const {
+    MoveMask result;
+    result.threatened = getThreatenedFields();
+    return result;
+}
+
+// Computes checkers and pins once so the generators only emit moves that do not leave the own king in check.
+template <bool amIWhite>
+MoveMask BoardView<amIWhite>::getLegalMask() const {
+    const auto& figures = position.figures;
+    if (!figures[OwnKing]) {
+        return getPseudoLegalMask();
+    }
+    MoveMask result;
+    const std::size_t kingSquare = __builtin_ctzll(figures[OwnKing]);
+    // the king must not be able to step back along the ray of a slider that gives check
+    result.threatened = getSideAttacks<!amIWhite>(figures[AnyFigure] & ~figures[OwnKing]);
+    const auto checkers = getCheckers();
+    if (__builtin_popcountll(checkers) > 1) {
+        result.evasions = 0ul;
+    }
+    else if (checkers) {
+        result.evasions = checkers | attacks::between(kingSquare, __builtin_ctzll(checkers));
+    }
+    const auto rookLike = figures[EnemyRook] | figures[EnemyQueen];
+    const auto bishopLike = figures[EnemyBishop] | figures[EnemyQueen];
+    const auto snipers = (attacks::rookAttacks(kingSquare, figures[EnemyFigure]) & rookLike) |
+        (attacks::bishopAttacks(kingSquare, figures[EnemyFigure]) & bishopLike);
+    std::size_t pinCounter = 0;
+    forEachPos(snipers, [&](std::uint64_t sniper) {
+        auto ray = attacks::between(kingSquare, __builtin_ctzll(sniper));
+        auto blockers = ray & figures[AnyFigure];
+        if (__builtin_popcountll(blockers) == 1 && (blockers & figures[OwnFigure])) {
+            result.pinned |= blockers;
+            result.pinRays[pinCounter++] = ray | sniper;
         }
-    };
-    auto conditionalKingFunc = [&](auto m) {
-        if (figures[None] & m.moveTo) {
-            if (!isThreatened(m.moveTo)) {
-                func(m);
+        return true;
+    });
+    // en passent removes two pieces from the same rank, so it is simply tried out
+    result.enPassentCapturers = 0ul;
+    if (position.enPassent) {
+        const auto captured = amIWhite ? position.enPassent << 8 : position.enPassent >> 8;
+        const auto capturers = attacks::pawnTable<!amIWhite>()[__builtin_ctzll(position.enPassent)] & figures[OwnPawn];
+        forEachPos(capturers, [&](std::uint64_t capturer) {
+            const auto obstacles = (figures[AnyFigure] & ~capturer & ~captured) | position.enPassent;
+            if (!((attacks::rookAttacks(kingSquare, obstacles) & rookLike) |
+                  (attacks::bishopAttacks(kingSquare, obstacles) & bishopLike) |
+                  (attacks::knightTable[kingSquare] & figures[EnemyKnight]) |
+                  (attacks::pawnTable<amIWhite>()[kingSquare] & figures[EnemyPawn] & ~captured))) {
+                result.enPassentCapturers |= capturer;
             }
             return true;
-        }
-        else if (figures[EnemyFigure] & m.moveTo) {
-            if (figures[OwnFigure] & m.moveTo) {
-                assert(false && "Memory error.");
-            }
-            if (!isThreatened(m.moveTo)) {
-                func(m);
-            }
-            return false;
-        }
-        else if (figures[OwnFigure] & m.moveTo) {
-            return false;
-        }
-        else {
-            assert(false && "Memory error.");
-            return false;
-        }
+        });
+    }
+    return result;
+}
+
+template <bool amIWhite>
+template <class F>
+void BoardView<amIWhite>::forEachMaskedMove(F&& func, const MoveMask& mask) const {
+    auto conditionalFunc = [&](auto m) {
+        assert((position.figures[None] | position.figures[EnemyFigure]) & m.moveTo && "Memory error.");
+        func(m);
+        return true;
     };
-    forEachPawnMove(conditionalFunc);
-    forEachKnightMove(conditionalFunc);
-    forEachBishopMove(conditionalFunc);
-    forEachRookMove(conditionalFunc);
-    forEachQueenMove(conditionalFunc);
-    forEachKingMove(conditionalKingFunc);
+    forEachPawnMove(conditionalFunc, mask);
+    forEachKnightMove(conditionalFunc, mask);
+    forEachBishopMove(conditionalFunc, mask);
+    forEachRookMove(conditionalFunc, mask);
+    forEachQueenMove(conditionalFunc, mask);
+    forEachKingMove(conditionalFunc, mask);
+}
+
+template <bool amIWhite>
+template <class F>
+void BoardView<amIWhite>::forEachValidMove(F&& func) const {
+    forEachMaskedMove(std::forward<F>(func), getPseudoLegalMask());
+}
+
+template <bool amIWhite>
+template <class F>
+void BoardView<amIWhite>::forEachLegalMove(F&& func) const {
+    forEachMaskedMove(std::forward<F>(func), getLegalMask());
 }
 
 template <bool amIWhite>
 template <piece fig>
-constexpr bool Board<amIWhite>::isThreatenedByFigure(std::uint64_t positions) const {
-    return !forEachPos(figures[fig], [&](std::uint64_t from) {
-        // TODO(mstaff): function naming
-        return !::isValidMove<fig>(
-            from, positions, figures[AnyFigure], castling[0], castling[1], castling[2], castling[3], enPassent);
+constexpr std::uint64_t BoardView<amIWhite>::getFigureAttacks() const {
+    if constexpr (isKing(fig)) {
+        return attacks::kingAttacks(position.figures[fig]);
+    }
+    else if constexpr (isKnight(fig)) {
+        return attacks::knightAttacks(position.figures[fig]);
+    }
+    else if constexpr (isPawn(fig)) {
+        return attacks::pawnAttacks<fig == WhitePawn>(position.figures[fig]);
+    }
+    else {
+        std::uint64_t result = 0ul;
+        forEachPos(position.figures[fig], [&](std::uint64_t from) {
+            if constexpr (isQueen(fig)) {
+                result |= attacks::queenAttacks(__builtin_ctzll(from), position.figures[AnyFigure]);
+            }
+            else if constexpr (isRook(fig)) {
+                result |= attacks::rookAttacks(__builtin_ctzll(from), position.figures[AnyFigure]);
+            }
+            else if constexpr (isBishop(fig)) {
+                result |= attacks::bishopAttacks(__builtin_ctzll(from), position.figures[AnyFigure]);
+            }
+            return true;
+        });
+        return result;
+    }
+}
+
+// All fields attacked by the given side in one pass. Queens are folded into the rook and bishop lookups so every
+// slider costs one table access per movement type.
+template <bool amIWhite>
+template <bool ofWhite>
+constexpr std::uint64_t BoardView<amIWhite>::getSideAttacks() const {
+    return getSideAttacks<ofWhite>(position.figures[AnyFigure]);
+}
+
+template <bool amIWhite>
+template <bool ofWhite>
+constexpr std::uint64_t BoardView<amIWhite>::getSideAttacks(std::uint64_t obstacles) const {
+    const auto& figures = position.figures;
+    constexpr piece king = ofWhite ? WhiteKing : BlackKing;
+    constexpr piece queen = ofWhite ? WhiteQueen : BlackQueen;
+    constexpr piece rook = ofWhite ? WhiteRook : BlackRook;
+    constexpr piece bishop = ofWhite ? WhiteBishop : BlackBishop;
+    constexpr piece knight = ofWhite ? WhiteKnight : BlackKnight;
+    constexpr piece pawn = ofWhite ? WhitePawn : BlackPawn;
+    std::uint64_t result = attacks::kingAttacks(figures[king]) | attacks::knightAttacks(figures[knight]) |
+        attacks::pawnAttacks<ofWhite>(figures[pawn]);
+    forEachPos(figures[rook] | figures[queen], [&](std::uint64_t from) {
+        result |= attacks::rookAttacks(__builtin_ctzll(from), obstacles);
+        return true;
     });
+    forEachPos(figures[bishop] | figures[queen], [&](std::uint64_t from) {
+        result |= attacks::bishopAttacks(__builtin_ctzll(from), obstacles);
+        return true;
+    });
+    return result;
 }
 
 template <bool amIWhite>
-constexpr bool Board<amIWhite>::isThreatened(std::uint64_t positions) const {
-    /*auto tmp1 = isThreatenedByFigure<EnemyRook>(positions);
-    auto tmp2 = isThreatenedByFigure<EnemyBishop>(positions);
-    auto tmp3 = isThreatenedByFigure<EnemyQueen>(positions);
-    auto tmp4 = isThreatenedByFigure<EnemyKnight>(positions);
-    auto tmp5 = isThreatenedByFigure<EnemyPawn>(positions);
-    auto tmp6 = isThreatenedByFigure<EnemyKing>(positions);
-    std::cout << "----" << tmp1 << tmp2 << tmp3 << tmp4 << tmp5 << tmp6 << "\n";
-    return tmp1 | tmp2 | tmp3 | tmp4 | tmp5 | tmp6;*/
-    return isThreatenedByFigure<EnemyRook>(positions) | isThreatenedByFigure<EnemyBishop>(positions) |
-        isThreatenedByFigure<EnemyQueen>(positions) | isThreatenedByFigure<EnemyKnight>(positions) |
-        isThreatenedByFigure<EnemyPawn>(positions) | isThreatenedByFigure<EnemyKing>(positions);
+constexpr std::uint64_t BoardView<amIWhite>::getThreatenedFields() const {
+    return getSideAttacks<!amIWhite>();
+}
+
+// Enemy pieces attacking the own king.
+template <bool amIWhite>
+constexpr std::uint64_t BoardView<amIWhite>::getCheckers() const {
+    const auto& figures = position.figures;
+    if (!figures[OwnKing]) {
+        return 0ul;
+    }
+    const std::size_t kingSquare = __builtin_ctzll(figures[OwnKing]);
+    return (attacks::rookAttacks(kingSquare, figures[AnyFigure]) & (figures[EnemyRook] | figures[EnemyQueen])) |
+        (attacks::bishopAttacks(kingSquare, figures[AnyFigure]) & (figures[EnemyBishop] | figures[EnemyQueen])) |
+        (attacks::knightTable[kingSquare] & figures[EnemyKnight]) |
+        (attacks::pawnTable<amIWhite>()[kingSquare] & figures[EnemyPawn]);
+}
+
+template <bool amIWhite>
+constexpr bool BoardView<amIWhite>::isInCheck() const {
+    return getCheckers();
+}
+
+template <bool amIWhite>
+template <piece fig>
+constexpr bool BoardView<amIWhite>::isThreatenedByFigure(std::uint64_t positions) const {
+    return getFigureAttacks<fig>() & positions;
+}
+
+template <bool amIWhite>
+constexpr bool BoardView<amIWhite>::isThreatened(std::uint64_t positions) const {
+    return getThreatenedFields() & positions;
 }
 
 template <bool amIWhite>
-constexpr bool Board<amIWhite>::isThreatenedDebugVariant(std::uint64_t positions) const {
+constexpr bool BoardView<amIWhite>::isThreatenedDebugVariant(std::uint64_t positions) const {
     auto tmp1 = isThreatenedByFigure<EnemyRook>(positions);
     auto tmp2 = isThreatenedByFigure<EnemyBishop>(positions);
     auto tmp3 = isThreatenedByFigure<EnemyQueen>(positions);
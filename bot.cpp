@@ -71,12 +71,35 @@ Bot::Bot() {
     weaknesses[BlackKnight] = -weaknesses[WhiteKnight];
     weaknesses[BlackPawn] = -weaknesses[WhitePawn];
     weaknesses[BlackFigure] = weaknesses[WhiteFigure];
+    // the piece-square tables start switched off so the default bot plays as before, mutations can turn them on
+    positions[None] = 0;
+    positions[AnyFigure] = 0;
+    positions[WhiteKing] = 0;
+    positions[WhiteQueen] = 0;
+    positions[WhiteRook] = 0;
+    positions[WhiteBishop] = 0;
+    positions[WhiteKnight] = 0;
+    positions[WhitePawn] = 0;
+    positions[WhiteFigure] = 0;
+    positions[BlackKing] = -positions[WhiteKing];
+    positions[BlackQueen] = -positions[WhiteQueen];
+    positions[BlackRook] = -positions[WhiteRook];
+    positions[BlackBishop] = -positions[WhiteBishop];
+    positions[BlackKnight] = -positions[WhiteKnight];
+    positions[BlackPawn] = -positions[WhitePawn];
+    positions[BlackFigure] = positions[WhiteFigure];
+    // the pawn structure terms start switched off as well
+    pawnStructure[pawns::Doubled] = 0;
+    pawnStructure[pawns::Isolated] = 0;
+    pawnStructure[pawns::Passed] = 0;
 }
 
 Bot::Bot(const Bot& previous, const double& mutationIntensity, std::mt19937& generator)
     : values(previous.values)
     , strengths(previous.strengths)
-    , weaknesses(previous.weaknesses) {
+    , weaknesses(previous.weaknesses)
+    , positions(previous.positions)
+    , pawnStructure(previous.pawnStructure) {
     std::uniform_real_distribution<double> distribution(0.0, 1.0);
     for (auto& i : values) {
         while (distribution(generator) < mutationIntensity) {
@@ -102,6 +125,64 @@ Bot::Bot(const Bot& previous, const double& mutationIntensity, std::mt19937& gen
             i -= 1;
         }
     }
+    for (auto& i : positions) {
+        while (distribution(generator) < mutationIntensity) {
+            i += 1;
+        }
+        while (distribution(generator) < mutationIntensity) {
+            i -= 1;
+        }
+    }
+    for (auto& i : pawnStructure) {
+        while (distribution(generator) < mutationIntensity) {
+            i += 1;
+        }
+        while (distribution(generator) < mutationIntensity) {
+            i -= 1;
+        }
+    }
+}
+
+std::uint64_t Bot::getParameterKey() const {
+    std::uint64_t result{0ul};
+    for (const auto* parameters : {&values, &strengths, &weaknesses, &positions}) {
+        for (auto i : *parameters) {
+            std::uint64_t state = result ^ static_cast<std::uint32_t>(i);
+            result = zobrist::nextRandom(state);
+        }
+    }
+    for (auto i : pawnStructure) {
+        std::uint64_t state = result ^ static_cast<std::uint32_t>(i);
+        result = zobrist::nextRandom(state);
+    }
+    return result;
+}
+
+void Bot::write(std::ostream& out) const {
+    for (const auto* parameters : {&values, &strengths, &weaknesses, &positions}) {
+        out.write(reinterpret_cast<const char*>(parameters->data()), sizeof(*parameters));
+    }
+    out.write(reinterpret_cast<const char*>(pawnStructure.data()), sizeof(pawnStructure));
+}
+
+void Bot::read(std::istream& in) {
+    for (auto* parameters : {&values, &strengths, &weaknesses, &positions}) {
+        in.read(reinterpret_cast<char*>(parameters->data()), sizeof(*parameters));
+    }
+    in.read(reinterpret_cast<char*>(pawnStructure.data()), sizeof(pawnStructure));
+}
+
+void Bot::writeFileHeader(std::ostream& out) {
+    out.write("BOTS", 4);
+    out.write(reinterpret_cast<const char*>(&fileVersion), sizeof(fileVersion));
+}
+
+bool Bot::readFileHeader(std::istream& in) {
+    std::string magic = "0000";
+    std::uint32_t version{0};
+    in.read(magic.data(), 4);
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    return in && magic == "BOTS" && version == fileVersion;
 }
 
 std::ostream& operator<<(std::ostream& stream, const Bot& bot) {
@@ -156,19 +237,43 @@ std::ostream& operator<<(std::ostream& stream, const Bot& bot) {
                     BlackFigure}) {
         stream << i << bot.weaknesses[i];
     }
-    stream << ")";
+    stream << "/";
+    for (piece i : {WhiteKing,
+                    WhiteQueen,
+                    WhiteRook,
+                    WhiteBishop,
+                    WhiteKnight,
+                    WhitePawn,
+                    WhiteFigure,
+                    BlackKing,
+                    BlackQueen,
+                    BlackRook,
+                    BlackBishop,
+                    BlackKnight,
+                    BlackPawn,
+                    BlackFigure}) {
+        stream << i << bot.positions[i];
+    }
+    stream << "/D" << bot.pawnStructure[pawns::Doubled] << "I" << bot.pawnStructure[pawns::Isolated] << "P"
+           << bot.pawnStructure[pawns::Passed] << ")";
     return stream;
 }
 
 bool operator<(const Bot& bot1, const Bot& bot2) {
     return bot1.values < bot2.values || (bot1.values == bot2.values && bot1.strengths < bot2.strengths) ||
-        (bot1.values == bot2.values && bot1.strengths == bot2.strengths && bot1.weaknesses < bot2.weaknesses);
+        (bot1.values == bot2.values && bot1.strengths == bot2.strengths && bot1.weaknesses < bot2.weaknesses) ||
+        (bot1.values == bot2.values && bot1.strengths == bot2.strengths && bot1.weaknesses == bot2.weaknesses &&
+         bot1.positions < bot2.positions) ||
+        (bot1.values == bot2.values && bot1.strengths == bot2.strengths && bot1.weaknesses == bot2.weaknesses &&
+         bot1.positions == bot2.positions && bot1.pawnStructure < bot2.pawnStructure);
 }
 
 bool operator!=(const Bot& bot1, const Bot& bot2) {
-    return bot1.values != bot2.values || bot1.strengths != bot2.strengths || bot1.weaknesses != bot2.weaknesses;
+    return bot1.values != bot2.values || bot1.strengths != bot2.strengths || bot1.weaknesses != bot2.weaknesses ||
+        bot1.positions != bot2.positions || bot1.pawnStructure != bot2.pawnStructure;
 }
 
 bool operator==(const Bot& bot1, const Bot& bot2) {
-    return bot1.values == bot2.values && bot1.strengths == bot2.strengths && bot1.weaknesses == bot2.weaknesses;
+    return bot1.values == bot2.values && bot1.strengths == bot2.strengths && bot1.weaknesses == bot2.weaknesses &&
+        bot1.positions == bot2.positions && bot1.pawnStructure == bot2.pawnStructure;
 }
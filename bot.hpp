@@ -1,14 +1,25 @@
 #pragma once
 
 #include "boardWrapper.hpp"
+#include "evaluationCache.hpp"
+#include "moveOrdering.hpp"
+#include "movePicker.hpp"
+#include "pawnTable.hpp"
+#include "principalVariation.hpp"
+#include "timeManager.hpp"
+#include "transpositionTable.hpp"
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iomanip>
 #include <limits>
 #include <list>
+#include <memory>
 #include <numeric>
 #include <random>
+#include <thread>
 #include <tuple>
+#include <vector>
 
 template <class A>
 struct ArraySizeImpl;
@@ -23,6 +34,28 @@ constexpr std::size_t arraySize() {
     return ArraySizeImpl<A>::N;
 }
 
+// Plies less to search a late quiet move with, by the remaining depth and the number of the move at its node. Grows
+// with both, as a move ordered late rarely turns out best and a deep search has more to spare.
+inline std::size_t getLateMoveReduction(std::size_t depth, std::size_t moveNumber) {
+    static const auto table = []() {
+        std::array<std::array<std::uint8_t, 64>, 64> result{};
+        for (std::size_t i = 1; i < 64; ++i) {
+            for (std::size_t j = 1; j < 64; ++j) {
+                result[i][j] = static_cast<std::uint8_t>(0.75 + std::log(i) * std::log(j) / 2.25);
+            }
+        }
+        return result;
+    }();
+    return table[std::min(depth, std::size_t{63})][std::min(moveNumber, std::size_t{63})];
+}
+
+// The chosen move along with its score and the line both parties are expected to play, starting with the move.
+struct SearchResult {
+    Move move;
+    int score{0};
+    std::vector<Move> line;
+};
+
 using time_point = std::chrono::steady_clock::time_point;
 using duration = std::chrono::steady_clock::duration;
 
@@ -42,50 +75,142 @@ struct Bot {
     std::array<int, 16> values;
     std::array<int, 16> strengths;
     std::array<int, 16> weaknesses;
+    // weights of the piece-square tables, in percent for each kind of piece and for each party
+    std::array<int, 16> positions;
+    // for each doubled, isolated and passed pawn, indexed by pawns::Term and multiplied by the Figure values
+    std::array<int, 3> pawnStructure;
     Bot();
-    Bot(std::array<int, 16> newValues, std::array<int, 16> newStrengths, std::array<int, 16> newWeaknesses)
+    Bot(std::array<int, 16> newValues, std::array<int, 16> newStrengths, std::array<int, 16> newWeaknesses,
+        std::array<int, 16> newPositions, std::array<int, 3> newPawnStructure)
         : values(newValues)
         , strengths(newStrengths)
-        , weaknesses(newWeaknesses) {}
+        , weaknesses(newWeaknesses)
+        , positions(newPositions)
+        , pawnStructure(newPawnStructure) {}
     Bot(const Bot& previous, const double& mutationIntensity, std::mt19937& generator);
 
     Bot(const Bot& other)
         : values(other.values)
         , strengths(other.strengths)
-        , weaknesses(other.weaknesses) {}
+        , weaknesses(other.weaknesses)
+        , positions(other.positions)
+        , pawnStructure(other.pawnStructure) {}
     Bot(Bot&& other)
         : values(std::move(other.values))
         , strengths(std::move(other.strengths))
-        , weaknesses(std::move(other.weaknesses)) {}
+        , weaknesses(std::move(other.weaknesses))
+        , positions(std::move(other.positions))
+        , pawnStructure(std::move(other.pawnStructure)) {}
     Bot& operator=(const Bot& other) {
         values = other.values;
         strengths = other.strengths;
         weaknesses = other.weaknesses;
+        positions = other.positions;
+        pawnStructure = other.pawnStructure;
         return *this;
     }
     Bot& operator=(Bot&& other) {
         values = std::move(other.values);
         strengths = std::move(other.strengths);
         weaknesses = std::move(other.weaknesses);
+        positions = std::move(other.positions);
+        pawnStructure = std::move(other.pawnStructure);
         return *this;
     }
 
-    template <std::size_t depth, bool loud>
-    Move getMove(BoardWrapper board);
+    // Only the parameters, for tournament and refining files. The search state and the table pointers are left out.
+    void write(std::ostream& out) const;
+    void read(std::istream& in);
+    // Tournament and refining files start with this version, it needs to be bumped whenever the parameters or the
+    // position layout change. readFileHeader rejects files of any other version.
+    constexpr const static std::uint32_t fileVersion = 2;
+    static void writeFileHeader(std::ostream& out);
+    static bool readFileHeader(std::istream& in);
+
+    template <bool loud>
+    SearchResult getMove(BoardWrapper board, std::size_t depth);
+
+    template <bool loud, bool amIWhite>
+    SearchResult getMove(Board<amIWhite> board, std::size_t depth);
 
-    template <std::size_t depth, bool loud, bool amIWhite>
-    Move getMove(Board<amIWhite> board);
+    template <bool loud>
+    SearchResult getMoveIteratively(BoardWrapper board, std::size_t maxDepth, TimeManager& time,
+                                    std::size_t threads = 1);
 
-    template <std::size_t depth, bool amIWhite>
-    Move getMoveSimple(Board<amIWhite> board);
+    template <bool loud, bool amIWhite>
+    SearchResult getMoveIteratively(Board<amIWhite> board, std::size_t maxDepth, TimeManager& time,
+                                    std::size_t threads = 1);
 
-    template <std::size_t depth, bool amIWhite>
-    int getScore(Board<amIWhite> board, int bestPreviousScore, int worstPreviousScore);
+    template <bool loud, bool amIWhite>
+    SearchResult searchIteratively(Board<amIWhite> board, std::size_t maxDepth, TimeManager& time,
+                                   std::size_t depthOffset);
 
-    template <std::size_t depth, bool amIWhite>
-    int getScoreSimple(Board<amIWhite> board, int bestPreviousScore, int worstPreviousScore);
+    template <bool amIWhite>
+    int searchRoot(BoardView<amIWhite> board, MoveList& moves, std::size_t depth, int bestPreviousScore,
+                   int worstPreviousScore);
+
+    template <bool amIWhite>
+    Move getMoveSimple(Board<amIWhite> board, std::size_t depth);
+
+    template <bool amIWhite>
+    int getScore(BoardView<amIWhite> board, std::size_t depth, int bestPreviousScore, int worstPreviousScore);
+
+    template <bool amIWhite>
+    int getQuiescenceScore(BoardView<amIWhite> board, int bestPreviousScore, int worstPreviousScore);
+
+    template <bool amIWhite>
+    int evaluate(const BoardView<amIWhite>& board);
+
+    template <bool amIWhite>
+    PawnTable::Entry getPawnStructure(const BoardView<amIWhite>& board);
+
+    template <bool amIWhite>
+    int getScoreSimple(Board<amIWhite> board, std::size_t depth, int bestPreviousScore, int worstPreviousScore);
+
+    // differs between bots with different parameters, combined with the position for the evaluation cache
+    std::uint64_t getParameterKey() const;
 
     std::int64_t counter{0};
+    // not owned and not copied along with the bot, searches without a table simply don't use one
+    TranspositionTable* table{nullptr};
+    TranspositionTable::Statistics tableStatistics;
+    // not owned and not copied either, the parameters must not change while a search uses it
+    EvaluationCache* evaluationCache{nullptr};
+    EvaluationCache::Statistics evaluationStatistics;
+    std::uint64_t parameterKey{0ul};
+    // not owned and not copied either, like the evaluation cache
+    PawnTable* pawnTable{nullptr};
+    PawnTable::Statistics pawnStatistics;
+    // set while getMoveIteratively runs, a stopped search unwinds without using or storing any further results
+    TimeManager* timeManager{nullptr};
+    std::uint32_t pollCounter{0};
+    // search state, neither copied nor allocated before the first search of this bot
+    std::unique_ptr<MoveOrdering> ordering;
+    std::unique_ptr<PrincipalVariation> principalVariation;
+    // no null moves below a node whose null move fail high is being verified
+    bool verifyingNullMove{false};
+
+    MoveOrdering& getOrdering() {
+        if (!ordering) {
+            ordering = std::make_unique<MoveOrdering>();
+        }
+        return *ordering;
+    }
+
+    PrincipalVariation& getPrincipalVariation() {
+        if (!principalVariation) {
+            principalVariation = std::make_unique<PrincipalVariation>();
+        }
+        return *principalVariation;
+    }
+
+    bool isStopped() {
+        if (!timeManager) {
+            return false;
+        }
+        // reading the clock is expensive compared to a search node
+        return ++pollCounter % 1024 == 0 ? timeManager->isOutOfTime() : timeManager->isStopped();
+    }
 };
 
 std::ostream& operator<<(std::ostream& stream, const Bot& bot);
@@ -93,160 +218,477 @@ bool operator<(const Bot& bot1, const Bot& bot2);
 bool operator!=(const Bot& bot1, const Bot& bot2);
 bool operator==(const Bot& bot1, const Bot& bot2);
 
-template <std::size_t depth, bool loud>
-Move Bot::getMove(BoardWrapper board) {
+template <bool loud>
+SearchResult Bot::getMove(BoardWrapper board, std::size_t depth) {
     if (board.amIWhite) {
-        return getMove<depth, loud>(board.whiteBoard);
+        return getMove<loud>(board.whiteBoard, depth);
     }
     else {
-        return getMove<depth, loud>(board.blackBoard);
+        return getMove<loud>(board.blackBoard, depth);
     }
 }
 
-template <std::size_t depth, bool loud, bool amIWhite>
-Move Bot::getMove(Board<amIWhite> board) {
+template <bool loud, bool amIWhite>
+SearchResult Bot::getMove(Board<amIWhite> board, std::size_t depth) {
+    assert(depth > 0);
     auto start [[maybe_unused]] = std::chrono::steady_clock::now();
-    Move bestMove = board.getFirstValidMove();
     // This number needs to be converted between positive and negative without any loss, thus the formula.
-    int bestScore = std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max());
-    int worstScore = -std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max());
-    board.forEachValidMove([&](auto move) {
-        Board<!amIWhite> tmp = board.applyMove(move);
-        int currentScore = -getScore<depth - 1>(tmp, -bestScore, -worstScore);
-        if (currentScore > bestScore) {
-            bestScore = currentScore;
-            bestMove = move;
-        }
-    });
+    constexpr int worstPossibleScore = std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max());
+    SearchResult result;
+    MoveList moves;
+    board.forEachLegalMove([&](const Move& move) { moves.emplace_back(move, 0); });
+    if (moves.empty()) {
+        return result;
+    }
+    if (table) {
+        table->nextGeneration();
+    }
+    getOrdering().age();
+    parameterKey = getParameterKey();
+    result.score = searchRoot(board, moves, depth, -worstPossibleScore, worstPossibleScore);
+    result.line = getPrincipalVariation().getLine();
+    if (result.line.empty()) {
+        // every move loses
+        result.line.push_back(board.unpackMove(moves[0].move));
+    }
+    result.move = result.line.front();
     if constexpr (loud) {
-        std::cout << "Chose " << bestMove << " in " << getMsSince(start) << "ms\n";
+        std::cout << "Chose " << result.move << " in " << getMsSince(start) << "ms\n";
     }
-    return bestMove;
+    return result;
 }
 
-template <std::size_t depth, bool amIWhite>
-int Bot::getScore(
-    Board<amIWhite> board, int bestPreviousScore [[maybe_unused]], int worstPreviousScore [[maybe_unused]]) {
-    if constexpr (depth == 0) {
-        ++counter;
+template <bool loud>
+SearchResult Bot::getMoveIteratively(BoardWrapper board, std::size_t maxDepth, TimeManager& time, std::size_t threads) {
+    if (board.amIWhite) {
+        return getMoveIteratively<loud>(board.whiteBoard, maxDepth, time, threads);
     }
-    if (board.figures[board.OwnKing] == 0) {
-        return std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max());
+    else {
+        return getMoveIteratively<loud>(board.blackBoard, maxDepth, time, threads);
     }
-    if (board.figures[board.EnemyKing] == 0) {
-        return std::min(-std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+}
+
+// Lazy SMP: helper threads search the same root on copies of this bot, every second one a depth ahead. They only
+// contribute through the shared transposition table, the move is the one found by the calling thread. Stops the time
+// manager once done so the helpers return as well.
+template <bool loud, bool amIWhite>
+SearchResult Bot::getMoveIteratively(Board<amIWhite> board, std::size_t maxDepth, TimeManager& time,
+                                     std::size_t threads) {
+    if (table) {
+        // once per move, the helpers store into the same generation
+        table->nextGeneration();
     }
-    if constexpr (depth == 0) {
-        int result{0};
-        static_assert(arraySize<decltype(values)>() >= arraySize<decltype(board.figures)>());
-        for (auto i : {board.OwnQueen, board.OwnRook, board.OwnBishop, board.OwnKnight, board.OwnPawn}) {
-            result += __builtin_popcountll(board.figures[i]) * values[i] * values[board.OwnFigure];
+    if (threads < 2 || !table) {
+        return searchIteratively<loud>(board, maxDepth, time, 0);
+    }
+    // copies have their own counters and search state, but don't take over the table
+    std::vector<Bot> helpers(threads - 1, *this);
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < helpers.size(); ++i) {
+        helpers[i].table = table;
+        helpers[i].evaluationCache = evaluationCache;
+        helpers[i].pawnTable = pawnTable;
+        workers.emplace_back([&, i]() { helpers[i].searchIteratively<false>(board, maxDepth, time, i % 2 + 1); });
+    }
+    auto result = searchIteratively<loud>(board, maxDepth, time, 0);
+    time.stop();
+    for (std::size_t i = 0; i < helpers.size(); ++i) {
+        workers[i].join();
+        counter += helpers[i].counter;
+        tableStatistics.probes += helpers[i].tableStatistics.probes;
+        tableStatistics.hits += helpers[i].tableStatistics.hits;
+        tableStatistics.stores += helpers[i].tableStatistics.stores;
+        tableStatistics.collisions += helpers[i].tableStatistics.collisions;
+        evaluationStatistics.probes += helpers[i].evaluationStatistics.probes;
+        evaluationStatistics.hits += helpers[i].evaluationStatistics.hits;
+        pawnStatistics.probes += helpers[i].pawnStatistics.probes;
+        pawnStatistics.hits += helpers[i].pawnStatistics.hits;
+    }
+    return result;
+}
+
+// Searches depth 1, 2, 3, ... until maxDepth or the time limit is reached. Every iteration starts with the best root
+// moves of the previous one, from depth 5 on within a narrow window around the previous score that is widened on
+// failure. An iteration interrupted by the time manager is discarded. Helper threads search depthOffset plies deeper.
+template <bool loud, bool amIWhite>
+SearchResult Bot::searchIteratively(Board<amIWhite> board, std::size_t maxDepth, TimeManager& time,
+                                    std::size_t depthOffset) {
+    assert(maxDepth > 0);
+    constexpr std::int64_t worstPossibleScore =
+        std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max());
+    constexpr std::int64_t bestPossibleScore = -worstPossibleScore;
+    MoveList moves;
+    board.forEachLegalMove([&](const Move& move) { moves.emplace_back(move, 0); });
+    if (moves.size() < 2) {
+        return moves.empty() ? SearchResult{} : SearchResult{board.unpackMove(moves[0].move), 0, {}};
+    }
+    SearchResult result{board.unpackMove(moves[0].move), 0, {}};
+    timeManager = &time;
+    getOrdering().age();
+    parameterKey = getParameterKey();
+    int score{0};
+    const std::size_t firstDepth = std::min(1 + depthOffset, maxDepth);
+    for (auto depth = firstDepth; depth <= maxDepth && (depth == firstDepth || time.canStartIteration()); ++depth) {
+        // a quarter pawn
+        std::int64_t window = std::abs(static_cast<std::int64_t>(values[WhitePawn]) * values[WhiteFigure]) / 4 + 1;
+        std::int64_t worstScore = depth >= 5 ? std::max(score - window, worstPossibleScore) : worstPossibleScore;
+        std::int64_t bestScore = depth >= 5 ? std::min(score + window, bestPossibleScore) : bestPossibleScore;
+        while (true) {
+            score = searchRoot(board, moves, depth, static_cast<int>(bestScore), static_cast<int>(worstScore));
+            if (time.isStopped()) {
+                break;
+            }
+            window *= 4;
+            if (score <= worstScore && worstScore > worstPossibleScore) {
+                worstScore = std::max(score - window, worstPossibleScore);
+            }
+            else if (score >= bestScore && bestScore < bestPossibleScore) {
+                bestScore = std::min(score + window, bestPossibleScore);
+            }
+            else {
+                break;
+            }
         }
-        for (auto i : {board.EnemyQueen, board.EnemyRook, board.EnemyBishop, board.EnemyKnight, board.EnemyPawn}) {
-            result += __builtin_popcountll(board.figures[i]) * values[i] * values[board.EnemyFigure];
+        if (time.isStopped()) {
+            break;
+        }
+        std::stable_sort(moves.begin(), moves.end(), [](const auto& a, const auto& b) { return a.score > b.score; });
+        result.move = board.unpackMove(moves[0].move);
+        result.score = score;
+        result.line = getPrincipalVariation().getLine();
+        if (result.line.empty() || result.line.front() != result.move) {
+            result.line.assign(1, result.move);
+        }
+        if constexpr (loud) {
+            std::cout << "Depth " << depth << ": " << result.move << " (" << score << ") after "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(time.getElapsed()).count() << "ms:";
+            for (const auto& move : result.line) {
+                std::cout << " " << move;
+            }
+            std::cout << "\n";
+        }
+    }
+    timeManager = nullptr;
+    if (result.line.empty()) {
+        result.line.push_back(result.move);
+    }
+    return result;
+}
+
+// Scores all root moves within the window, stopping at the first one that reaches bestPreviousScore. Only the first
+// move gets the full window, the others are first searched with a null window at alpha. Leaves the line of the best
+// move in the principal variation.
+template <bool amIWhite>
+int Bot::searchRoot(BoardView<amIWhite> board, MoveList& moves, std::size_t depth, int bestPreviousScore,
+                    int worstPreviousScore) {
+    auto& moveOrdering = getOrdering();
+    auto& variation = getPrincipalVariation();
+    variation.clear(moveOrdering.getPly());
+    int bestScore{std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max())};
+    for (auto& it : moves) {
+        const int alpha = std::max(bestScore, worstPreviousScore);
+        Move move = board.unpackMove(it.move);
+        auto undo = board.makeMove(move);
+        moveOrdering.push(move);
+        if (&it != moves.begin()) {
+            it.score = -getScore(board.flipped(), depth - 1, -alpha, -alpha - 1);
+        }
+        if (&it == moves.begin() ||
+            (it.score > alpha && it.score < bestPreviousScore && !(timeManager && timeManager->isStopped()))) {
+            it.score = -getScore(board.flipped(), depth - 1, -alpha, -bestPreviousScore);
         }
-        board.forEachValidMove([&](const Move& move) {
-            result += strengths[move.turnFrom] * strengths[board.OwnFigure];
-            result -= weaknesses[board.figureAt(move.moveTo)] * weaknesses[board.EnemyFigure];
-        });
-        Board<!amIWhite> invertedBoard(board);
-        invertedBoard.forEachValidMove([&](const Move& move) {
-            result += strengths[move.turnFrom] * strengths[board.EnemyFigure];
-            result -= weaknesses[board.figureAt(move.moveTo)] * weaknesses[board.OwnFigure];
-        });
-        if constexpr (amIWhite) {
-            return result;
+        moveOrdering.pop();
+        board.unmakeMove(move, undo);
+        if (timeManager && timeManager->isStopped()) {
+            break;
         }
-        else {
-            return -result;
+        if (it.score > bestScore) {
+            bestScore = it.score;
+            variation.update(moveOrdering.getPly(), move);
         }
+        if (bestScore >= bestPreviousScore) {
+            break;
+        }
+    }
+    return bestScore;
+}
+
+template <bool amIWhite>
+int Bot::getScore(BoardView<amIWhite> board, std::size_t depth, int bestPreviousScore, int worstPreviousScore) {
+    if (isStopped()) {
+        return 0;
+    }
+    auto& moveOrdering = getOrdering();
+    auto& variation = getPrincipalVariation();
+    variation.clear(moveOrdering.getPly());
+    if (board.position.figures[board.OwnKing] == 0) {
+        return std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max());
+    }
+    if (board.position.figures[board.EnemyKing] == 0) {
+        return std::min(-std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+    }
+    if (depth == 0) {
+        return getQuiescenceScore(board, bestPreviousScore, worstPreviousScore);
     }
     else {
-        std::vector<std::tuple<Move, Board<amIWhite>, int, int>> situations;
-        situations.reserve(64ul);
         // this number needs to be within the range set by getMove for bestScore.
         int bestScore{std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max()) + 1};
         int bestPossibleScore{-std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max())};
-        int shallowScore = getScore<0>(board, bestPreviousScore, worstPreviousScore);
-        board.forEachValidMove([&](const Move& move) { situations.push_back({move, board.applyMove(move), 0, 0}); });
-        //++moveCounter[std::min(situations.size(), 64ul)];
-        for (auto& it : situations) {
-            if (std::get<1>(it).figures[board.EnemyKing] == 0ul) {
-                return bestPossibleScore;
+        PackedMove hashMove{};
+        if (table) {
+            TranspositionTable::Entry entry;
+            if (table->probe(board.getHash(), entry, tableStatistics)) {
+                hashMove = entry.move;
+                if (entry.depth >= depth &&
+                    (entry.bound == TranspositionTable::ExactBound ||
+                     (entry.bound == TranspositionTable::LowerBound && entry.score >= bestPreviousScore) ||
+                     (entry.bound == TranspositionTable::UpperBound && entry.score <= worstPreviousScore))) {
+                    return entry.score;
+                }
             }
-            std::get<2>(it) = -getScore<0>(std::get<1>(it), -worstPreviousScore, -bestPreviousScore);
         }
-        constexpr const static size_t pruningCounter = 10;
-        if (situations.size() > pruningCounter) {
-            std::partial_sort(
-                situations.begin(), situations.begin() + pruningCounter, situations.end(), [](auto a, auto b) {
-                    return std::get<2>(a) > std::get<2>(b);
-                });
-            if constexpr (depth > 3) {
-                for (auto it = situations.begin(); it < situations.end(); ++it) {
-                    if (std::get<1>(*it).isThreatened(std::get<1>(*it).figures[board.OwnKing])) {
-                        std::get<2>(*it) = -bestPossibleScore;
-                    }
-                    int doubleMovePruningScore = getScore<0>(std::get<1>(*it), bestPreviousScore, worstPreviousScore);
-                    if (doubleMovePruningScore < shallowScore * 2 + 100) {
-                        std::get<2>(*it) = -bestPossibleScore / 2;
-                    }
+        const bool inCheck = board.isInCheck();
+        // Null move pruning: if passing the turn still fails high at a reduced depth, nearly every real move would as
+        // well. Not in check, not twice in a row and not without pieces, where passing could be the best move. Fail
+        // highs at higher depths are verified by a reduced search of this node without null moves.
+        if (depth >= 3 && !verifyingNullMove && bestPreviousScore < bestPossibleScore &&
+            bestPreviousScore > -bestPossibleScore + 1 && !moveOrdering.followsNullMove() &&
+            (board.position.figures[board.OwnQueen] | board.position.figures[board.OwnRook] |
+             board.position.figures[board.OwnBishop] | board.position.figures[board.OwnKnight]) &&
+            !inCheck) {
+            const std::size_t reduction = depth >= 7 ? 3 : 2;
+            auto undo = board.makeNullMove();
+            moveOrdering.push(Move{});
+            int nullScore =
+                -getScore(board.flipped(), depth - 1 - reduction, -bestPreviousScore + 1, -bestPreviousScore);
+            moveOrdering.pop();
+            board.unmakeNullMove(undo);
+            if (timeManager && timeManager->isStopped()) {
+                return 0;
+            }
+            if (nullScore >= bestPreviousScore) {
+                if (depth < 6) {
+                    return bestPreviousScore;
+                }
+                verifyingNullMove = true;
+                int verifiedScore = getScore(board, depth - reduction, bestPreviousScore, bestPreviousScore - 1);
+                verifyingNullMove = false;
+                if (timeManager && timeManager->isStopped()) {
+                    return 0;
                 }
-                std::partial_sort(
-                    situations.begin(), situations.begin() + pruningCounter, situations.end(), [](auto a, auto b) {
-                        return std::get<2>(a) > std::get<2>(b);
-                    });
+                if (verifiedScore >= bestPreviousScore) {
+                    return bestPreviousScore;
+                }
+                // the verification searched this very node
+                variation.clear(moveOrdering.getPly());
             }
         }
-        for (auto& it : situations) {
+        std::size_t moveCount{0};
+        Move bestMove{};
+        MovePicker<amIWhite> picker{
+            board, hashMove, moveOrdering.getRefutations(), &moveOrdering.getHistory(amIWhite)};
+        FixedList<PackedMove> triedQuiets;
+        for (Move move = picker.next(); move != Move{}; move = picker.next()) {
+            ++moveCount;
+            const bool quiet = board.isQuiet(move);
+            const int alpha = std::max(bestScore, worstPreviousScore);
+            auto undo = board.makeMove(move);
+            moveOrdering.push(move);
+            int currentScore{0};
+            if (moveCount == 1) {
+                currentScore = -getScore(board.flipped(), depth - 1, -alpha, -bestPreviousScore);
+            }
+            else {
+                // Late move reductions: quiet moves after the first few are searched shallower, unless they are
+                // in or into check.
+                std::size_t reduction{0};
+                if (depth >= 3 && moveCount > 3 && quiet && !inCheck && !board.flipped().isInCheck()) {
+                    reduction = std::min(getLateMoveReduction(depth, moveCount), depth - 2);
+                }
+                // Principal variation search: after the first move the others only have to be proven not to beat
+                // alpha, which a null window does cheaper. The ones that unexpectedly do are searched again.
+                currentScore = -getScore(board.flipped(), depth - 1 - reduction, -alpha, -alpha - 1);
+                if (reduction > 0 && currentScore > alpha && !(timeManager && timeManager->isStopped())) {
+                    currentScore = -getScore(board.flipped(), depth - 1, -alpha, -alpha - 1);
+                }
+                if (currentScore > alpha && currentScore < bestPreviousScore &&
+                    !(timeManager && timeManager->isStopped())) {
+                    currentScore = -getScore(board.flipped(), depth - 1, -alpha, -bestPreviousScore);
+                }
+            }
+            moveOrdering.pop();
+            board.unmakeMove(move, undo);
+            if (timeManager && timeManager->isStopped()) {
+                return 0;
+            }
+            if (currentScore > bestScore) {
+                bestScore = currentScore;
+                bestMove = move;
+                variation.update(moveOrdering.getPly(), move);
+            }
             // alpha-beta-pruning
             if (bestScore >= bestPreviousScore) {
+                if (quiet) {
+                    moveOrdering.update(amIWhite, move, triedQuiets, depth);
+                }
                 break;
             }
-            Board<!amIWhite> tmp{std::get<1>(it)};
-            int currentScore = -getScore<depth - 1>(tmp, -worstPreviousScore, -bestPreviousScore);
-            if (currentScore > bestScore) {
-                bestScore = currentScore;
+            if (quiet) {
+                triedQuiets.emplace_back(move);
             }
         }
-        return bestScore; /*
-         board.forEachValidMove([&](const Move& move) {
-             // alpha-beta-pruning
-             if (bestScore >= bestPreviousScore) {
-                 return;
-             }
-             // double-move-pruning and avoiding to run into check
-             if constexpr (depth > 3) {
-                 Board<amIWhite> doubleMovePruningBoard = board.applyMove(move);
-                 if (doubleMovePruningBoard.isThreatened(doubleMovePruningBoard.figures[WhiteKing])) {
-                     return;
-                 }
-                 int doubleMovePruningScore =
-                     getScore<depth % 2 + 2>(doubleMovePruningBoard, bestPreviousScore, worstPreviousScore);
-                 if (doubleMovePruningScore < shallowScore * 2 + 100) {
-                     return;
-                 }
-             }
-             Board<!amIWhite> tmp = board.applyMove(move);
-             int currentScore = -getScore<depth - 1>(tmp, -worstPreviousScore, -bestPreviousScore);
-             if (currentScore > bestScore) {
-                 bestScore = currentScore;
-             }
-         });
-         return bestScore;*/
+        if (moveCount == 0) {
+            // checkmate or stalemate
+            bestScore = inCheck ? -bestPossibleScore : 0;
+        }
+        if (table) {
+            auto bound = bestScore >= bestPreviousScore ? TranspositionTable::LowerBound
+                : bestScore <= worstPreviousScore      ? TranspositionTable::UpperBound
+                                                       : TranspositionTable::ExactBound;
+            table->store(
+                board.getHash(),
+                {bestScore, static_cast<std::uint8_t>(depth), moveCount ? bound : TranspositionTable::ExactBound,
+                 PackedMove{bestMove}},
+                tableStatistics);
+        }
+        return bestScore;
     }
 }
 
-template <std::size_t depth, bool amIWhite>
-Move Bot::getMoveSimple(Board<amIWhite> board) {
+// Resolves captures and promotions below the leaves of the main search, so a hanging piece isn't evaluated as if it
+// was safe. Without being in check the side to move may stand pat on the static evaluation instead of capturing.
+template <bool amIWhite>
+int Bot::getQuiescenceScore(BoardView<amIWhite> board, int bestPreviousScore, int worstPreviousScore) {
+    if (isStopped()) {
+        return 0;
+    }
+    const bool inCheck = board.isInCheck();
+    int bestScore{std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max()) + 1};
+    if (!inCheck) {
+        bestScore = evaluate(board);
+        if (bestScore >= bestPreviousScore) {
+            return bestScore;
+        }
+    }
+    // captures that can't get the score above alpha even with a spare pawn and a half are skipped
+    const int deltaMargin = std::abs(values[WhitePawn] * values[WhiteFigure]) * 3 / 2;
+    std::size_t moveCount{0};
+    auto picker = inCheck ? MovePicker<amIWhite>{board} : MovePicker<amIWhite>::forQuiescence(board);
+    for (Move move = picker.next(); move != Move{}; move = picker.next()) {
+        ++moveCount;
+        const int alpha = std::max(bestScore, worstPreviousScore);
+        if (!inCheck && move.turnFrom == move.turnTo) {
+            auto victim = board.figureAt(move.moveTo);
+            // en passent
+            if (victim == None) {
+                victim = board.EnemyPawn;
+            }
+            if (static_cast<std::int64_t>(bestScore) + std::abs(values[victim] * values[board.EnemyFigure]) +
+                    deltaMargin <=
+                alpha) {
+                continue;
+            }
+        }
+        auto undo = board.makeMove(move);
+        int currentScore = -getQuiescenceScore(board.flipped(), -alpha, -bestPreviousScore);
+        board.unmakeMove(move, undo);
+        if (timeManager && timeManager->isStopped()) {
+            return 0;
+        }
+        if (currentScore > bestScore) {
+            bestScore = currentScore;
+        }
+        if (bestScore >= bestPreviousScore) {
+            break;
+        }
+    }
+    if (inCheck && moveCount == 0) {
+        // checkmate
+        return std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max());
+    }
+    return bestScore;
+}
+
+template <bool amIWhite>
+int Bot::evaluate(const BoardView<amIWhite>& board) {
+    ++counter;
+    int result{0};
+    const auto key = board.getHash() ^ parameterKey;
+    if (evaluationCache && evaluationCache->probe(key, result, evaluationStatistics)) {
+        return result;
+    }
+    static_assert(arraySize<decltype(values)>() >= arraySize<decltype(board.position.figures)>());
+    for (auto i : {board.OwnQueen, board.OwnRook, board.OwnBishop, board.OwnKnight, board.OwnPawn}) {
+        result += board.position.terms.counts[i] * values[i] * values[board.OwnFigure];
+    }
+    for (auto i : {board.EnemyQueen, board.EnemyRook, board.EnemyBishop, board.EnemyKnight, board.EnemyPawn}) {
+        result += board.position.terms.counts[i] * values[i] * values[board.EnemyFigure];
+    }
+    // the tables are in centipawns, so a weight of 100% for both the piece and the party equals a pawn of 100 * 100
+    for (auto i : {board.OwnKing, board.OwnQueen, board.OwnRook, board.OwnBishop, board.OwnKnight, board.OwnPawn}) {
+        result += board.position.terms.getTapered(i) * positions[i] * positions[board.OwnFigure];
+    }
+    for (auto i : {board.EnemyKing, board.EnemyQueen, board.EnemyRook, board.EnemyBishop, board.EnemyKnight,
+                   board.EnemyPawn}) {
+        result += board.position.terms.getTapered(i) * positions[i] * positions[board.EnemyFigure];
+    }
+    result += getPawnStructure(board).score;
+    // every pseudo-legal move adds the strength of the moving piece and removes the weakness of what it attacks
+    const auto own = board.getMobility();
+    const auto enemy = board.flipped().getMobility();
+    for (auto i : {board.OwnKing, board.OwnQueen, board.OwnRook, board.OwnBishop, board.OwnKnight, board.OwnPawn}) {
+        result += own.moves[i] * strengths[i] * strengths[board.OwnFigure];
+        result -= enemy.targets[i] * weaknesses[i] * weaknesses[board.OwnFigure];
+    }
+    for (auto i : {board.EnemyKing, board.EnemyQueen, board.EnemyRook, board.EnemyBishop, board.EnemyKnight,
+                   board.EnemyPawn}) {
+        result += enemy.moves[i] * strengths[i] * strengths[board.EnemyFigure];
+        result -= own.targets[i] * weaknesses[i] * weaknesses[board.EnemyFigure];
+    }
+    result -= own.targets[None] * weaknesses[None] * weaknesses[board.EnemyFigure];
+    result -= enemy.targets[None] * weaknesses[None] * weaknesses[board.OwnFigure];
+    if constexpr (!amIWhite) {
+        result = -result;
+    }
+    if (evaluationCache) {
+        evaluationCache->store(key, result);
+    }
+    return result;
+}
+
+// Looks the pawn structure up in the pawn table before evaluating it, it changes with few moves only.
+template <bool amIWhite>
+PawnTable::Entry Bot::getPawnStructure(const BoardView<amIWhite>& board) {
+    PawnTable::Entry result;
+    const auto key = board.position.terms.pawnKey ^ parameterKey;
+    if (pawnTable && pawnTable->probe(key, result, pawnStatistics)) {
+        return result;
+    }
+    const auto white = board.position.figures[WhitePawn];
+    const auto black = board.position.figures[BlackPawn];
+    result.attackSpans = {pawns::attackSpan<true>(white), pawns::attackSpan<false>(black)};
+    const auto whiteCounts = pawns::count<true>(white, black, result.attackSpans[1]);
+    const auto blackCounts = pawns::count<false>(black, white, result.attackSpans[0]);
+    for (std::size_t i = 0; i < pawnStructure.size(); ++i) {
+        result.score +=
+            (whiteCounts[i] * values[WhiteFigure] - blackCounts[i] * values[BlackFigure]) * pawnStructure[i];
+    }
+    if (pawnTable) {
+        pawnTable->store(key, result);
+    }
+    return result;
+}
+
+template <bool amIWhite>
+Move Bot::getMoveSimple(Board<amIWhite> board, std::size_t depth) {
     auto start [[maybe_unused]] = std::chrono::steady_clock::now();
-    Move bestMove = board.getFirstValidMove();
+    Move bestMove = board.getFirstLegalMove();
     // This number needs to be converted between positive and negative without any loss, thus the formula.
     int bestScore{std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max())};
-    board.forEachValidMove([&](auto move) {
+    board.forEachLegalMove([&](auto move) {
         Board<!amIWhite> tmp = board.applyMove(move);
-        int currentScore = -getScoreSimple<depth - 1>(
-            tmp, -bestScore, std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max()));
+        int currentScore = -getScoreSimple(
+            tmp, depth - 1, -bestScore, std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max()));
         if (currentScore > bestScore) {
             bestScore = currentScore;
             bestMove = move;
@@ -255,16 +697,15 @@ Move Bot::getMoveSimple(Board<amIWhite> board) {
     return bestMove;
 }
 
-template <std::size_t depth, bool amIWhite>
-int Bot::getScoreSimple(
-    Board<amIWhite> board, int bestPreviousScore [[maybe_unused]], int worstPreviousScore [[maybe_unused]]) {
+template <bool amIWhite>
+int Bot::getScoreSimple(Board<amIWhite> board, std::size_t depth, int bestPreviousScore, int worstPreviousScore) {
     if (board.figures[board.OwnKing] == 0) {
         return std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max());
     }
     if (board.figures[board.EnemyKing] == 0) {
         return std::min(-std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
     }
-    if constexpr (depth == 0) {
+    if (depth == 0) {
         int result{0};
         static_assert(arraySize<decltype(values)>() >= arraySize<decltype(board.figures)>());
         for (auto i : {board.OwnQueen, board.OwnRook, board.OwnBishop, board.OwnKnight, board.OwnPawn}) {
@@ -276,24 +717,25 @@ int Bot::getScoreSimple(
         return result;
     }
     else {
-        std::vector<Board<!amIWhite>> situations;
-        situations.reserve(64ul);
+        MoveList situations;
         // this number needs to be within the range set by getMove for bestScore.
         int bestScore{std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max()) + 1};
         int bestPossibleScore{-std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max())};
-        board.forEachValidMove([&](const Move& move) { situations.push_back(board.applyMove(move)); });
+        board.forEachLegalMove([&](const Move& move) { situations.emplace_back(move, 0); });
         //++moveCounter[std::min(situations.size(), 64ul)];
-        for (auto& it : situations) {
-            if (it.figures[board.EnemyKing] == 0ul) {
-                return bestPossibleScore;
-            }
+        if (situations.empty()) {
+            // checkmate or stalemate
+            return board.isInCheck() ? -bestPossibleScore : 0;
         }
         for (auto& it : situations) { /*
              // alpha-beta-pruning
              if (bestScore >= bestPreviousScore) {
                  break;
              }*/
-            int currentScore = -getScore<depth - 1>(it, -worstPreviousScore, -bestPreviousScore);
+            Move move = board.unpackMove(it.move);
+            auto undo = board.makeMove(move);
+            int currentScore = -getScore(board.flipped(), depth - 1, -worstPreviousScore, -bestPreviousScore);
+            board.unmakeMove(move, undo);
             if (currentScore > bestScore) {
                 bestScore = currentScore;
             }
@@ -6,7 +6,7 @@ from sys import argv
 from PIL import Image, ImageDraw, ImageFont
 import pyautogui
 
-values = ["values", "strengths", "weaknesses"]
+values = ["values", "strengths", "weaknesses", "positions"]
 figures = "KQRBNPFkqrbnpf)"
 
 def interpretBot(bot):
@@ -16,10 +16,13 @@ def interpretBot(bot):
         bot = bot[4:]
         bot = bot[:bot.find(")")]
     bot = bot.split("/")
-    if len(bot) != 3:
+    # bots printed before the positions were added only have three parts
+    if len(bot) not in [3, 4, 5]:
         print("Skipping" + str(bot) + ".")
         return
-    for i in [0,1,2]:
+    # the pawn structure has no pieces to draw
+    bot = bot[:4]
+    for i in range(len(bot)):
         result[values[i]] = {}
         for j in range(len(figures) - 1):
             figScore = int(bot[i].split(figures[j], 1)[1].split(figures[j+1])[0])
@@ -95,7 +98,7 @@ def createBezier(coords, curves):
     return points
 
 def displayBot(bot, imageSize):
-    defaultBot = interpretBot("K10000Q900R500B300N300P100F10000k-10000q-900r-500b-300n-300p-100f10000/K10Q90R50B30N30P10F10k-10q-90r-50b-30n-30p-10f10/K100000Q90R50B30N30P10F10k-100000q-90r-50b-30n-30p-10f10")
+    defaultBot = interpretBot("K10000Q900R500B300N300P100F10000k-10000q-900r-500b-300n-300p-100f10000/K10Q90R50B30N30P10F10k-10q-90r-50b-30n-30p-10f10/K100000Q90R50B30N30P10F10k-100000q-90r-50b-30n-30p-10f10/K100Q100R100B100N100P100F100k-100q-100r-100b-100n-100p-100f100")
     fontPath = "/usr/share/fonts/ubuntu/Ubuntu-R.ttf"
     antiAliasing = 4
     lineWidth = 1
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+// Static evaluations of previously seen positions, shared between all search threads without locks. Direct mapped:
+// the upper bits of the key choose the slot, which holds the lower half of the key next to the score in a single word,
+// so a concurrent write can't tear an entry apart. The key has to cover the parameters of the evaluating bot as well,
+// so bots with different parameters may share one cache.
+class EvaluationCache {
+public:
+    // Counted by the caller, so concurrent searches don't contend over shared counters.
+    struct Statistics {
+        std::uint64_t probes{0ul};
+        std::uint64_t hits{0ul};
+    };
+
+    EvaluationCache(std::size_t megabytes);
+
+    bool probe(std::uint64_t key, int& score, Statistics& counters) const;
+    void store(std::uint64_t key, int score);
+
+    std::size_t getSize() const { return slotCount; }
+
+private:
+    static std::uint64_t pack(std::uint64_t key, int score) {
+        return (key << 32) | static_cast<std::uint32_t>(score);
+    }
+
+    std::atomic<std::uint64_t>& getSlot(std::uint64_t key) const {
+        // maps the key onto the slots without a division
+        return slots[static_cast<std::size_t>((static_cast<unsigned __int128>(key) * slotCount) >> 64)];
+    }
+
+    std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+    std::size_t slotCount{0ul};
+};
+
+inline EvaluationCache::EvaluationCache(std::size_t megabytes)
+    : slots(std::make_unique<std::atomic<std::uint64_t>[]>(
+          std::max(megabytes * 1024ul * 1024ul / sizeof(std::atomic<std::uint64_t>), 1ul)))
+    , slotCount(std::max(megabytes * 1024ul * 1024ul / sizeof(std::atomic<std::uint64_t>), 1ul)) {}
+
+inline bool EvaluationCache::probe(std::uint64_t key, int& score, Statistics& counters) const {
+    ++counters.probes;
+    auto data = getSlot(key).load(std::memory_order_relaxed);
+    // an empty slot reads as key and score zero, such a position simply never hits
+    if (!data || (data >> 32) != (key & 0xfffffffful)) {
+        return false;
+    }
+    score = static_cast<int>(static_cast<std::uint32_t>(data));
+    ++counters.hits;
+    return true;
+}
+
+// always replaces, a newer position is more likely to come up again
+inline void EvaluationCache::store(std::uint64_t key, int score) {
+    getSlot(key).store(pack(key, score), std::memory_order_relaxed);
+}
+
+inline std::ostream& operator<<(std::ostream& stream, const EvaluationCache::Statistics& counters) {
+    return stream << "Evaluation cache: " << counters.hits << "/" << counters.probes << " hits";
+}
@@ -141,6 +141,8 @@ auto parseParameters(int argc, char const* argv[]) -> Parameters {
     if (userDefinedCastling) {
         result.first.whiteBoard.castling = castling;
         result.first.blackBoard.castling = castling;
+        result.first.whiteBoard.fillZobrist();
+        result.first.blackBoard.fillZobrist();
     }
     return result;
 }
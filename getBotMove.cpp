@@ -10,7 +10,19 @@
 #include <string>
 #include <variant>
 
-using Parameters = std::pair<BoardWrapper, std::variant<std::size_t, std::chrono::steady_clock::duration>>;
+// remaining time on the own clock and the increment per move
+struct Clock {
+    std::chrono::steady_clock::duration remaining;
+    std::chrono::steady_clock::duration increment;
+};
+
+struct Parameters {
+    BoardWrapper situation;
+    std::variant<std::size_t, std::chrono::steady_clock::duration, Clock> threshold;
+    // size of the transposition table in megabytes
+    std::size_t hashSize;
+    std::size_t threads;
+};
 
 auto getDurationFromString(std::string arg) -> std::chrono::steady_clock::duration {
     if (arg.ends_with("ns")) {
@@ -60,7 +72,8 @@ auto parseParameters(int argc, char const* argv[]) -> Parameters {
     std::array<bool, 4> castling{true, true, true, true};
     bool userDefinedCastling = false;
     bool userDefinedParty = false;
-    Parameters result{Board<true>{"rnbqkbnrpppppppp8888PPPPPPPPRNBQKBNR"}, std::chrono::milliseconds{200}};
+    std::chrono::steady_clock::duration increment{0};
+    Parameters result{Board<true>{"rnbqkbnrpppppppp8888PPPPPPPPRNBQKBNR"}, std::chrono::milliseconds{200}, 64ul, 1ul};
 
     for (int i = 1; i < argc; ++i) {
         std::string arg{argv[i]};
@@ -69,16 +82,16 @@ auto parseParameters(int argc, char const* argv[]) -> Parameters {
                 parameterMode = false;
             }
             else if (arg.starts_with("-t")) {
-                result.second = getDurationFromString(parseArgument(arg, "-t", i, argc, argv));
-                if (std::get<std::chrono::steady_clock::duration>(result.second) < std::chrono::seconds{1}) {
-                    std::cerr << "Warning: Minimum depth is 4, time might be exceeded.\n";
-                }
+                result.threshold = getDurationFromString(parseArgument(arg, "-t", i, argc, argv));
             }
             else if (arg.starts_with("--time")) {
-                result.second = getDurationFromString(parseArgument(arg, "--time", i, argc, argv));
-                if (std::get<std::chrono::steady_clock::duration>(result.second) < std::chrono::seconds{1}) {
-                    std::cerr << "Warning: Minimum depth is 4, time might be exceeded.\n";
-                }
+                result.threshold = getDurationFromString(parseArgument(arg, "--time", i, argc, argv));
+            }
+            else if (arg.starts_with("--clock")) {
+                result.threshold = Clock{getDurationFromString(parseArgument(arg, "--clock", i, argc, argv)), {}};
+            }
+            else if (arg.starts_with("--increment")) {
+                increment = getDurationFromString(parseArgument(arg, "--increment", i, argc, argv));
             }
             else if (arg.starts_with("-d")) {
                 std::size_t tmp = std::stoll(parseArgument(arg, "-d", i, argc, argv));
@@ -87,7 +100,7 @@ auto parseParameters(int argc, char const* argv[]) -> Parameters {
                     exit(1);
                 }
                 else {
-                    result.second = tmp;
+                    result.threshold = tmp;
                 }
             }
             else if (arg.starts_with("--depth")) {
@@ -97,9 +110,18 @@ auto parseParameters(int argc, char const* argv[]) -> Parameters {
                     exit(1);
                 }
                 else {
-                    result.second = tmp;
+                    result.threshold = tmp;
                 }
             }
+            else if (arg.starts_with("--hash")) {
+                result.hashSize = std::stoul(parseArgument(arg, "--hash", i, argc, argv));
+            }
+            else if (arg.starts_with("--threads")) {
+                result.threads = std::max(std::stoul(parseArgument(arg, "--threads", i, argc, argv)), 1ul);
+            }
+            else if (arg.starts_with("-j")) {
+                result.threads = std::max(std::stoul(parseArgument(arg, "-j", i, argc, argv)), 1ul);
+            }
             else if (arg.starts_with("-c")) {
                 auto castlingString = parseArgument(arg, "-c", i, argc, argv);
                 if (castlingString.size() < castling.size()) {
@@ -121,88 +143,59 @@ auto parseParameters(int argc, char const* argv[]) -> Parameters {
                 userDefinedCastling = true;
             }
             else if (arg.starts_with("-w") || arg.starts_with("--white") || arg.starts_with("--play-white")) {
-                result.first.amIWhite = true;
+                result.situation.amIWhite = true;
                 userDefinedParty = true;
             }
             else if (arg.starts_with("-b") || arg.starts_with("--black") || arg.starts_with("--play-black")) {
-                result.first.amIWhite = false;
+                result.situation.amIWhite = false;
                 userDefinedParty = true;
             }
             else {
-                result.first.whiteBoard = Board<true>{arg};
-                result.first.blackBoard = result.first.whiteBoard;
+                result.situation.whiteBoard = Board<true>{arg};
+                result.situation.blackBoard = result.situation.whiteBoard;
             }
         }
         else {
-            result.first.whiteBoard = Board<true>{arg};
-            result.first.blackBoard = result.first.whiteBoard;
+            result.situation.whiteBoard = Board<true>{arg};
+            result.situation.blackBoard = result.situation.whiteBoard;
         }
     }
+    if (std::holds_alternative<Clock>(result.threshold)) {
+        std::get<Clock>(result.threshold).increment = increment;
+    }
     if (userDefinedCastling) {
-        result.first.whiteBoard.castling = castling;
-        result.first.blackBoard.castling = castling;
+        result.situation.whiteBoard.castling = castling;
+        result.situation.blackBoard.castling = castling;
+        result.situation.whiteBoard.fillZobrist();
+        result.situation.blackBoard.fillZobrist();
     }
     return result;
 }
 
 int main(int argc, char const* argv[]) {
-    auto&& [currentSituation, threshold] = parseParameters(argc, argv);
+    auto&& [currentSituation, threshold, hashSize, threads] = parseParameters(argc, argv);
     Bot currentBot;
+    TranspositionTable table{hashSize};
+    currentBot.table = &table;
+    EvaluationCache evaluationCache{std::max(hashSize / 4, std::size_t{1})};
+    currentBot.evaluationCache = &evaluationCache;
+    PawnTable pawnTable{std::max(hashSize / 16, std::size_t{1})};
+    currentBot.pawnTable = &pawnTable;
     // Note: can't use visit here because I can't capture structured bindings in a lambda function.
     if (std::holds_alternative<std::size_t>(threshold)) {
         auto depth = std::get<std::size_t>(threshold);
-#define MOVE(d)                                                                                                        \
-    if (depth == d##ul) {                                                                                              \
-        std::cout << currentBot.getMove<d##ul, false>(currentSituation) << "\n";                                       \
-    }
-        MOVE(4)
-        MOVE(5)
-        MOVE(6)
-        MOVE(7)
-        MOVE(8)
-        MOVE(9)
-        MOVE(10)
-        MOVE(11)
-        MOVE(12)
-        MOVE(13)
-        MOVE(14)
-        MOVE(15)
-        MOVE(16)
-        MOVE(17)
-        MOVE(18)
-        MOVE(19)
-        MOVE(20)
-#undef MOVE
+        TimeManager time;
+        std::cout << currentBot.getMoveIteratively<false>(currentSituation, depth, time, threads).move << "\n";
     }
     else if (std::holds_alternative<std::chrono::steady_clock::duration>(threshold)) {
         auto timeThreshold = std::get<std::chrono::steady_clock::duration>(threshold);
-        auto start = std::chrono::steady_clock::now();
-        auto chosenMove = currentBot.getMove<4, false>(currentSituation);
-        if (std::chrono::steady_clock::now() - start < timeThreshold) {
-            chosenMove = currentBot.getMove<6, false>(currentSituation);
-        }
-        if (std::chrono::steady_clock::now() - start < timeThreshold) {
-            chosenMove = currentBot.getMove<8, false>(currentSituation);
-        }
-        if (std::chrono::steady_clock::now() - start < timeThreshold) {
-            chosenMove = currentBot.getMove<10, false>(currentSituation);
-        }
-        if (std::chrono::steady_clock::now() - start < timeThreshold) {
-            chosenMove = currentBot.getMove<12, false>(currentSituation);
-        }
-        if (std::chrono::steady_clock::now() - start < timeThreshold) {
-            chosenMove = currentBot.getMove<14, false>(currentSituation);
-        }
-        if (std::chrono::steady_clock::now() - start < timeThreshold) {
-            chosenMove = currentBot.getMove<16, false>(currentSituation);
-        }
-        if (std::chrono::steady_clock::now() - start < timeThreshold) {
-            chosenMove = currentBot.getMove<18, false>(currentSituation);
-        }
-        if (std::chrono::steady_clock::now() - start < timeThreshold) {
-            chosenMove = currentBot.getMove<20, false>(currentSituation);
-        }
-        std::cout << chosenMove << "\n";
+        TimeManager time{timeThreshold};
+        std::cout << currentBot.getMoveIteratively<false>(currentSituation, 20, time, threads).move << "\n";
+    }
+    else if (std::holds_alternative<Clock>(threshold)) {
+        auto clock = std::get<Clock>(threshold);
+        auto time = TimeManager::forClock(clock.remaining, clock.increment);
+        std::cout << currentBot.getMoveIteratively<false>(currentSituation, 20, time, threads).move << "\n";
     }
     return 0;
 }
@@ -57,7 +57,7 @@ int main(int argc [[maybe_unused]], char const* argv [[maybe_unused]][]) {
     }
     auto chosenMove = getCachedMove(cacheFilename, argv[argc - 1]);
     if (chosenMove == "") {
-        std::cout << Bot{}.getMove<4, false>(BoardWrapper{white, argv[argc - 1]}) << "\n";
+        std::cout << Bot{}.getMove<false>(BoardWrapper{white, argv[argc - 1]}, 4).move << "\n";
     }
     else {
         std::cout << chosenMove << " .\n";
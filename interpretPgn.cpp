@@ -123,24 +123,20 @@ Move interpretMove(BoardWrapper currentBoard, std::string move, bool verbose = f
         });
         bool foundMatch = false;
         if (currentBoard.amIWhite) {
-            currentBoard.whiteBoard.forEachValidMove([&](auto m) {
-                auto newBoard = currentBoard.whiteBoard.applyMove(m);
+            currentBoard.whiteBoard.forEachLegalMove([&](auto m) {
                 if ((m.moveTo == result.moveTo) && (m.moveFrom & result.moveFrom) == m.moveFrom &&
                     (result.turnFrom == None || m.turnFrom == result.turnFrom) &&
-                    (result.turnTo == None || m.turnTo == result.turnTo) &&
-                    !newBoard.isThreatened(newBoard.figures[newBoard.OwnKing])) {
+                    (result.turnTo == None || m.turnTo == result.turnTo)) {
                     result = m;
                     foundMatch = true;
                 }
             });
         }
         else {
-            currentBoard.blackBoard.forEachValidMove([&](auto m) {
-                auto newBoard = currentBoard.blackBoard.applyMove(m);
+            currentBoard.blackBoard.forEachLegalMove([&](auto m) {
                 if ((m.moveTo == result.moveTo) && (m.moveFrom & result.moveFrom) == m.moveFrom &&
                     (result.turnFrom == None || m.turnFrom == result.turnFrom) &&
-                    (result.turnTo == None || m.turnTo == result.turnTo) &&
-                    !newBoard.isThreatened(newBoard.figures[newBoard.OwnKing])) {
+                    (result.turnTo == None || m.turnTo == result.turnTo)) {
                     result = m;
                     foundMatch = true;
                 }
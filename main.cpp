@@ -93,30 +93,31 @@ ostream& operator<<(ostream& stream, const vector<string>& objects) {
 }
 } // namespace std
 
-template <std::size_t depth, bool amIWhite, class P>
-void justificateMove(Bot& bot, Board<amIWhite>& board, P pos) {
-    auto move = bot.getMove<depth, false>(board);
-    Board<!amIWhite> tmp = board.applyMove(move);
-    *pos = tmp.print();
-    if constexpr (depth > 1) {
-        justificateMove<depth - 1>(bot, tmp, ++pos);
+// prints the positions along the line the search expects both parties to play
+template <bool amIWhite, class P>
+void justificateMove(const Board<amIWhite>& board, const std::vector<Move>& line, std::size_t index, P pos) {
+    if (index >= line.size()) {
+        return;
     }
+    Board<!amIWhite> tmp = board.applyMove(line[index]);
+    *pos = tmp.print();
+    justificateMove(tmp, line, index + 1, ++pos);
 }
 
-template <std::size_t depth, bool loud, bool amIWhite>
-Move getMove(Bot& bot, Board<amIWhite>& board) {
+template <bool loud, bool amIWhite>
+Move getMove(Bot& bot, Board<amIWhite>& board, std::size_t depth) {
     if constexpr (loud) {
         std::cout << "Depth: " << depth << std::endl;
     }
-    auto chosenMove = bot.getMove<depth, loud>(board);
+    auto result = bot.getMove<loud>(board, depth);
     // bot.resetStats();
     if constexpr (loud) {
         std::vector<std::string> objs;
-        justificateMove<depth>(bot, board, std::back_inserter(objs));
+        justificateMove(board, result.line, 0, std::back_inserter(objs));
         std::cout << "Justification:\n" << objs;
     }
     std::flush(std::cout);
-    return chosenMove;
+    return result.move;
 }
 
 int main(int argc [[maybe_unused]], char const* argv [[maybe_unused]][]) {
@@ -143,6 +144,12 @@ int main(int argc [[maybe_unused]], char const* argv [[maybe_unused]][]) {
     Board<true> currentSituation(initBoard);
     Board<false> otherSituation;
     Bot currentBot;
+    TranspositionTable table{64ul};
+    currentBot.table = &table;
+    EvaluationCache evaluationCache{16ul};
+    currentBot.evaluationCache = &evaluationCache;
+    PawnTable pawnTable{4ul};
+    currentBot.pawnTable = &pawnTable;
     totalStart = std::chrono::steady_clock::now();
     totalMoves = 0;
     int sameCounter = 0;
@@ -168,9 +175,15 @@ int main(int argc [[maybe_unused]], char const* argv [[maybe_unused]][]) {
         else {
             chosenMove = getInputMove(currentSituation);
         }*/
-        chosenMove = getMove<4, false>(currentBot, currentSituation);
+        chosenMove = getMove<false>(currentBot, currentSituation, 4);
+        if (chosenMove == Move{}) {
+            // checkmate or stalemate
+            break;
+        }
         std::cout << "Chose " << chosenMove << " in " << getMsSince(start) << " ms out of " << currentBot.counter
-                  << " moves (" << currentBot.counter / (getMsSince(start) + 1) << "/ms).\n";
+                  << " moves (" << currentBot.counter / (getMsSince(start) + 1) << "/ms). "
+                  << currentBot.tableStatistics << ". " << currentBot.evaluationStatistics << ". "
+                  << currentBot.pawnStatistics << "\n";
         decltype(otherSituation) tmp1 = std::move(otherSituation);
         otherSituation = currentSituation.applyMove(chosenMove);
         if (otherSituation == tmp1) {
@@ -185,9 +198,15 @@ int main(int argc [[maybe_unused]], char const* argv [[maybe_unused]][]) {
         start = std::chrono::steady_clock::now();
         totalMoves += currentBot.counter;
         currentBot.counter = 0;
-        chosenMove = getMove<4, false>(currentBot, otherSituation);
+        chosenMove = getMove<false>(currentBot, otherSituation, 4);
+        if (chosenMove == Move{}) {
+            // checkmate or stalemate
+            break;
+        }
         std::cout << "Chose " << chosenMove << " in " << getMsSince(start) << " ms out of " << currentBot.counter
-                  << " moves (" << currentBot.counter / (getMsSince(start) + 1) << "/ms).\n";
+                  << " moves (" << currentBot.counter / (getMsSince(start) + 1) << "/ms). "
+                  << currentBot.tableStatistics << ". " << currentBot.evaluationStatistics << ". "
+                  << currentBot.pawnStatistics << "\n";
         decltype(currentSituation) tmp2 = std::move(currentSituation);
         currentSituation = otherSituation.applyMove(chosenMove);
         if (currentSituation == tmp2) {
@@ -1,4 +1,5 @@
 #include "move.hpp"
+#include "attacks.hpp"
 
 #include <sstream>
 
@@ -46,16 +47,16 @@ bool isValidMove(
         }
     }
     else if (isQueen(move.turnFrom)) {
-        return isValidQueenMove(move.moveFrom, move.moveTo, obstacles);
+        return attacks::queenAttacks(__builtin_ctzll(move.moveFrom), obstacles) & move.moveTo;
     }
     else if (isRook(move.turnFrom)) {
-        return isValidRookMove(move.moveFrom, move.moveTo, obstacles);
+        return attacks::rookAttacks(__builtin_ctzll(move.moveFrom), obstacles) & move.moveTo;
     }
     else if (isBishop(move.turnFrom)) {
-        return isValidBishopMove(move.moveFrom, move.moveTo, obstacles);
+        return attacks::bishopAttacks(__builtin_ctzll(move.moveFrom), obstacles) & move.moveTo;
     }
     else if (isKnight(move.turnFrom)) {
-        return isValidKnightMove(move.moveFrom, move.moveTo, obstacles);
+        return attacks::knightTable[__builtin_ctzll(move.moveFrom)] & move.moveTo;
     }
     else if (isPawn(move.turnFrom)) {
         if (move.turnFrom == WhitePawn) {
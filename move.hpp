@@ -3,7 +3,9 @@
 
 #include <cassert>
 #include <cstdint>
+#include <new>
 #include <sstream>
+#include <type_traits>
 #include <utility>
 
 constexpr const static std::uint64_t whiteKingStartPos = 0b00010000ul << 56;
@@ -116,6 +118,87 @@ constexpr bool operator==(const Move& l, const Move& r) {
     return l.moveFrom == r.moveFrom && l.moveTo == r.moveTo && l.turnFrom == r.turnFrom && l.turnTo == r.turnTo;
 }
 
+// 16 bit encoding of a move for lists, caches and files. Bits 0-5 hold the origin square, bits 6-11 the target square,
+// bits 12-13 the promotion piece (queen, rook, bishop, knight) and bit 14 marks promotions. The moving piece is not
+// stored, Board::unpackMove restores it from the position. The null move Move{} is encoded as 0.
+struct PackedMove {
+    std::uint16_t data{0};
+
+    constexpr PackedMove() {}
+    constexpr PackedMove(const Move& move) {
+        if (!move.moveFrom) {
+            return;
+        }
+        data = __builtin_ctzll(move.moveFrom) | (__builtin_ctzll(move.moveTo) << 6);
+        if (move.turnFrom != move.turnTo) {
+            data |= (1u << 14) | ((move.turnTo - (isWhite(move.turnTo) ? WhiteQueen : BlackQueen)) << 12);
+        }
+    }
+    PackedMove(std::string movestr)
+        : PackedMove(Move{movestr}) {}
+
+    constexpr std::uint8_t from() const { return data & 0x3f; }
+    constexpr std::uint8_t to() const { return (data >> 6) & 0x3f; }
+    constexpr bool isPromotion() const { return data & (1u << 14); }
+    // offset of the promoted piece from the queen of the same color
+    constexpr std::uint8_t promotion() const { return (data >> 12) & 0x3; }
+};
+
+static_assert(sizeof(PackedMove) == 2);
+// written to the move caches as raw bytes
+static_assert(std::is_trivially_copyable_v<PackedMove>);
+
+constexpr bool operator<(const PackedMove& l, const PackedMove& r) { return l.data < r.data; }
+constexpr bool operator!=(const PackedMove& l, const PackedMove& r) { return l.data != r.data; }
+constexpr bool operator==(const PackedMove& l, const PackedMove& r) { return l.data == r.data; }
+
+struct ScoredMove {
+    PackedMove move;
+    int score;
+};
+
+// Stack-resident list with a fixed capacity. 256 is above the maximum number of legal moves in any position. The
+// storage is left uninitialized, so creating a list per search node costs nothing.
+template <class T, std::size_t capacity = 256>
+class FixedList {
+public:
+    FixedList() {}
+
+    template <class... Args>
+    T& emplace_back(Args&&... args) {
+        assert(count < capacity);
+        T* result = new (&storage[count]) T{std::forward<Args>(args)...};
+        ++count;
+        return *result;
+    }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear() { count = 0; }
+
+    T& operator[](std::size_t i) { return data()[i]; }
+    const T& operator[](std::size_t i) const { return data()[i]; }
+
+    T* begin() { return data(); }
+    T* end() { return data() + count; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + count; }
+
+private:
+    static_assert(std::is_trivially_destructible_v<T> && std::is_trivially_copyable_v<T>);
+
+    T* data() { return std::launder(reinterpret_cast<T*>(storage)); }
+    const T* data() const { return std::launder(reinterpret_cast<const T*>(storage)); }
+
+    struct alignas(T) Slot {
+        unsigned char bytes[sizeof(T)];
+    };
+    Slot storage[capacity];
+    std::size_t count{0};
+};
+
+using MoveList = FixedList<ScoredMove>;
+
 constexpr std::int8_t getIntDir(Direction dir) {
     std::int8_t result = 0;
     if (dir & N) {
@@ -354,6 +437,14 @@ constexpr bool forEachPos(std::uint64_t positions, F&& func) {
     return true;
 }
 
+template <class F>
+constexpr bool forEachMove(std::uint64_t from, std::uint64_t targets, piece turnFrom, piece turnTo, F&& func) {
+    return forEachPos(targets, [&](std::uint64_t to) {
+        func(Move(from, to, turnFrom, turnTo));
+        return true;
+    });
+}
+
 template <bool amIWhite>
 constexpr bool isCastling(
     std::uint64_t from,
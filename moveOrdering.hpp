@@ -0,0 +1,94 @@
+#pragma once
+#include "move.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+// Remembers which quiet moves refuted earlier nodes of a search, so the move picker can try them early elsewhere:
+// two killer moves per ply, a history score per side and from/to square pair (the butterfly board) and the reply
+// that last refuted each move of the opponent. Every search thread keeps its own, updates cost a few array accesses.
+class MoveOrdering {
+public:
+    constexpr const static std::size_t maxPly = 128;
+    using History = std::array<std::array<int, 64>, 64>;
+
+    // the moves leading from the root to the current node, the quiescence search doesn't track its moves
+    void push(const Move& move) {
+        if (ply < maxPly) {
+            moves[ply] = move;
+        }
+        ++ply;
+    }
+    void pop() { --ply; }
+    std::size_t getPly() const { return ply; }
+    // null moves are pushed as Move{}
+    bool followsNullMove() const { return ply > 0 && ply <= maxPly && !moves[ply - 1].moveFrom; }
+
+    // both killers of the current ply followed by the counter move to the previous move
+    std::array<PackedMove, 3> getRefutations() const;
+    const History& getHistory(bool white) const { return history[white]; }
+
+    // A quiet move caused a cutoff at the current node after all quiet moves in tried failed to do so.
+    template <class List>
+    void update(bool white, const Move& move, const List& tried, std::size_t depth);
+
+    // killers only apply to the position they were found in, the history keeps half of its weight for the next search
+    void age();
+
+private:
+    constexpr const static int maxHistory = 1 << 14;
+
+    // moves the entry towards the limit of the same sign, so neither an old nor a frequent move stays on top forever
+    static void addBonus(int& entry, int bonus) { entry += bonus - entry * std::abs(bonus) / maxHistory; }
+
+    std::array<std::array<PackedMove, 2>, maxPly> killers{};
+    std::array<History, 2> history{};
+    // indexed by the piece the previous move placed and its target square
+    std::array<std::array<PackedMove, 64>, 16> counterMoves{};
+    std::array<Move, maxPly> moves;
+    std::size_t ply{0};
+};
+
+inline std::array<PackedMove, 3> MoveOrdering::getRefutations() const {
+    std::array<PackedMove, 3> result{};
+    if (ply < maxPly) {
+        result[0] = killers[ply][0];
+        result[1] = killers[ply][1];
+    }
+    if (ply > 0 && ply <= maxPly && moves[ply - 1].moveTo) {
+        const auto& previous = moves[ply - 1];
+        result[2] = counterMoves[previous.turnTo][__builtin_ctzll(previous.moveTo)];
+    }
+    return result;
+}
+
+template <class List>
+void MoveOrdering::update(bool white, const Move& move, const List& tried, std::size_t depth) {
+    const PackedMove packed{move};
+    if (ply < maxPly && killers[ply][0] != packed) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = packed;
+    }
+    if (ply > 0 && ply <= maxPly && moves[ply - 1].moveTo) {
+        const auto& previous = moves[ply - 1];
+        counterMoves[previous.turnTo][__builtin_ctzll(previous.moveTo)] = packed;
+    }
+    const int bonus = static_cast<int>(std::min(depth * depth, std::size_t{400}));
+    addBonus(history[white][packed.from()][packed.to()], bonus);
+    for (const PackedMove& it : tried) {
+        addBonus(history[white][it.from()][it.to()], -bonus);
+    }
+}
+
+inline void MoveOrdering::age() {
+    killers = {};
+    for (auto& side : history) {
+        for (auto& from : side) {
+            for (auto& entry : from) {
+                entry /= 2;
+            }
+        }
+    }
+}
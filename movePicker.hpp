@@ -0,0 +1,165 @@
+#pragma once
+#include "board.hpp"
+#include "moveOrdering.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+// Hands out the legal moves of a position one at a time: first the hash move, then captures and promotions with the
+// most valuable victim first, then the killer and counter moves and finally all remaining quiet moves by their
+// history score. Every stage is only generated once the previous one is exhausted, so a cutoff on an early move saves
+// generating the rest.
+template <bool amIWhite>
+class MovePicker {
+public:
+    MovePicker(const BoardView<amIWhite>& newBoard, PackedMove newHashMove = PackedMove{},
+               std::array<PackedMove, 3> newRefutations = {}, const MoveOrdering::History* newHistory = nullptr)
+        : board(newBoard)
+        , mask(newBoard.getLegalMask())
+        , hashMove(newHashMove)
+        , refutations(newRefutations)
+        , history(newHistory) {}
+
+    // only captures and promotions, for the quiescence search
+    static MovePicker forQuiescence(const BoardView<amIWhite>& board) {
+        MovePicker result{board};
+        result.stage = Stage::GenerateCaptures;
+        result.quiescence = true;
+        return result;
+    }
+
+    // returns Move{} once all moves have been handed out
+    Move next();
+
+private:
+    enum class Stage { HashMove, GenerateCaptures, Captures, Refutations, GenerateQuiets, Quiets, Done };
+
+    // 0 for kings up to 5 for pawns
+    constexpr static int getRank(piece fig) { return (fig - 1) % 7; }
+
+    // selection sort, one step per handed out move
+    PackedMove pickBest() {
+        auto best = current;
+        for (auto i = current + 1; i < moves.size(); ++i) {
+            if (moves[i].score > moves[best].score) {
+                best = i;
+            }
+        }
+        std::swap(moves[current], moves[best]);
+        return moves[current++].move;
+    }
+
+    bool isSpecial(PackedMove move) const {
+        return move == hashMove ||
+            (stage >= Stage::Refutations &&
+             std::find(refutations.begin(), refutations.end(), move) != refutations.end());
+    }
+
+    const BoardView<amIWhite> board;
+    MoveMask mask;
+    PackedMove hashMove;
+    std::array<PackedMove, 3> refutations;
+    const MoveOrdering::History* history;
+    Stage stage{Stage::HashMove};
+    bool quiescence{false};
+    std::size_t refutationIndex{0};
+    std::size_t current{0};
+    MoveList moves;
+};
+
+template <bool amIWhite>
+Move MovePicker<amIWhite>::next() {
+    switch (stage) {
+    case Stage::HashMove:
+        stage = Stage::GenerateCaptures;
+        if (hashMove != PackedMove{}) {
+            auto move = board.unpackMove(hashMove);
+            if (board.isLegalMove(move, mask)) {
+                // unused bits of a corrupted entry must not hand out the move twice
+                hashMove = PackedMove{move};
+                return move;
+            }
+            hashMove = PackedMove{};
+        }
+        [[fallthrough]];
+    case Stage::GenerateCaptures:
+        mask.targets = board.position.figures[board.EnemyFigure];
+        {
+            auto scoreMove = [&](const Move& move) {
+                // en passent leaves the target empty, the victim is a pawn as well
+                auto victim = board.figureAt(move.moveTo);
+                int victimValue = victim == None ? 1 : 6 - getRank(victim);
+                int attackerValue = isKing(move.turnFrom) ? 6 : 6 - getRank(move.turnFrom);
+                // a promotion wins the promoted piece, under-promotions come last
+                if (move.turnFrom != move.turnTo) {
+                    victimValue += isQueen(move.turnTo) ? 5 : -6;
+                }
+                moves.emplace_back(move, victimValue * 8 - attackerValue);
+            };
+            board.forEachMaskedMove(scoreMove, mask);
+            auto promotionMask = mask;
+            promotionMask.targets = board.position.figures[None] & (amIWhite ? attacks::rank8 : attacks::rank1);
+            board.forEachPawnMove(scoreMove, promotionMask);
+        }
+        stage = Stage::Captures;
+        [[fallthrough]];
+    case Stage::Captures:
+        while (current < moves.size()) {
+            // most captures are never looked at
+            auto move = pickBest();
+            if (!isSpecial(move)) {
+                return board.unpackMove(move);
+            }
+        }
+        if (quiescence) {
+            stage = Stage::Done;
+            return Move{};
+        }
+        stage = Stage::Refutations;
+        [[fallthrough]];
+    case Stage::Refutations:
+        mask.targets = board.position.figures[None];
+        while (refutationIndex < refutations.size()) {
+            auto& refutation = refutations[refutationIndex++];
+            if (refutation == PackedMove{}) {
+                continue;
+            }
+            // refutations are quiet moves, captures and promotions were handed out already
+            auto move = board.unpackMove(refutation);
+            if (refutation.isPromotion() || !board.isLegalMove(move, mask)) {
+                refutation = PackedMove{};
+                continue;
+            }
+            refutation = PackedMove{move};
+            auto previous = refutations.begin() + static_cast<std::ptrdiff_t>(refutationIndex - 1);
+            if (refutation != hashMove && std::find(refutations.begin(), previous, refutation) == previous) {
+                return move;
+            }
+        }
+        stage = Stage::GenerateQuiets;
+        [[fallthrough]];
+    case Stage::GenerateQuiets:
+        moves.clear();
+        current = 0;
+        board.forEachMaskedMove(
+            [&](const Move& move) {
+                PackedMove packed{move};
+                moves.emplace_back(packed, history ? (*history)[packed.from()][packed.to()] : 0);
+            },
+            mask);
+        stage = Stage::Quiets;
+        [[fallthrough]];
+    case Stage::Quiets:
+        while (current < moves.size()) {
+            auto move = history ? pickBest() : moves[current++].move;
+            if (!isSpecial(move) && !move.isPromotion()) {
+                return board.unpackMove(move);
+            }
+        }
+        stage = Stage::Done;
+        [[fallthrough]];
+    case Stage::Done: break;
+    }
+    return Move{};
+}
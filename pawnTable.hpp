@@ -0,0 +1,132 @@
+#pragma once
+#include "attacks.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+namespace pawns {
+
+// indices of the pawn structure parameters of a bot, each counted once per pawn
+enum Term : std::size_t { Doubled = 0, Isolated = 1, Passed = 2 };
+
+// The positions along with every field in front of them, from the point of view of the given party.
+template <bool white>
+constexpr std::uint64_t frontFill(std::uint64_t positions) {
+    if constexpr (white) {
+        positions |= positions >> 8;
+        positions |= positions >> 16;
+        return positions | positions >> 32;
+    }
+    else {
+        positions |= positions << 8;
+        positions |= positions << 16;
+        return positions | positions << 32;
+    }
+}
+
+template <bool white>
+constexpr std::uint64_t frontSpan(std::uint64_t positions) {
+    return frontFill<white>(attacks::shift<white ? N : S>(positions));
+}
+
+// every field pawns of the given party could ever attack by moving forward
+template <bool white>
+constexpr std::uint64_t attackSpan(std::uint64_t pawns) {
+    return frontFill<white>(attacks::pawnAttacks<white>(pawns));
+}
+
+// Pawns with another one of their party in front of them are doubled, pawns without any of their party on the
+// neighbouring files are isolated. Passed pawns can't be stopped or captured by enemy pawns anymore, the rear one of
+// doubled pawns doesn't count.
+template <bool white>
+constexpr std::array<int, 3> count(std::uint64_t own, std::uint64_t enemy, std::uint64_t enemyAttackSpan) {
+    std::array<int, 3> result{};
+    result[Doubled] = __builtin_popcountll(own & frontSpan<!white>(own));
+    const auto files = frontFill<true>(frontFill<false>(own));
+    result[Isolated] = __builtin_popcountll(own & ~(attacks::shift<E>(files) | attacks::shift<W>(files)));
+    result[Passed] =
+        __builtin_popcountll(own & ~frontFill<!white>(enemy | enemyAttackSpan) & ~frontSpan<!white>(own));
+    return result;
+}
+
+} // namespace pawns
+
+// Evaluations of previously seen pawn structures, shared between all search threads without locks. The pawns change
+// with few moves only, so most positions of a search share the structure of some earlier one. Direct mapped, every
+// entry consists of four words and the first holds the key xor'ed with the other three, so a torn write simply doesn't
+// match on the next probe. Just like the evaluation cache the key has to cover the parameters of the evaluating bot.
+class PawnTable {
+public:
+    struct Entry {
+        // from white's point of view
+        int score{0};
+        // pawns::attackSpan of white and black
+        std::array<std::uint64_t, 2> attackSpans{};
+    };
+
+    // Counted by the caller, so concurrent searches don't contend over shared counters.
+    struct Statistics {
+        std::uint64_t probes{0ul};
+        std::uint64_t hits{0ul};
+    };
+
+    PawnTable(std::size_t megabytes);
+
+    bool probe(std::uint64_t key, Entry& result, Statistics& counters) const;
+    void store(std::uint64_t key, const Entry& entry);
+
+    std::size_t getSize() const { return slotCount; }
+
+private:
+    // an empty slot only matches the key zero
+    struct Slot {
+        std::atomic<std::uint64_t> check{0ul};
+        std::atomic<std::uint64_t> score{0ul};
+        std::array<std::atomic<std::uint64_t>, 2> attackSpans{};
+    };
+
+    Slot& getSlot(std::uint64_t key) const {
+        // maps the key onto the slots without a division
+        return slots[static_cast<std::size_t>((static_cast<unsigned __int128>(key) * slotCount) >> 64)];
+    }
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t slotCount{0ul};
+};
+
+inline PawnTable::PawnTable(std::size_t megabytes)
+    : slots(std::make_unique<Slot[]>(std::max(megabytes * 1024ul * 1024ul / sizeof(Slot), 1ul)))
+    , slotCount(std::max(megabytes * 1024ul * 1024ul / sizeof(Slot), 1ul)) {}
+
+inline bool PawnTable::probe(std::uint64_t key, Entry& result, Statistics& counters) const {
+    ++counters.probes;
+    auto& slot = getSlot(key);
+    const auto score = slot.score.load(std::memory_order_relaxed);
+    const auto white = slot.attackSpans[0].load(std::memory_order_relaxed);
+    const auto black = slot.attackSpans[1].load(std::memory_order_relaxed);
+    if ((slot.check.load(std::memory_order_relaxed) ^ score ^ white ^ black) != key) {
+        return false;
+    }
+    result.score = static_cast<int>(static_cast<std::uint32_t>(score));
+    result.attackSpans = {white, black};
+    ++counters.hits;
+    return true;
+}
+
+// always replaces, a newer structure is more likely to come up again
+inline void PawnTable::store(std::uint64_t key, const Entry& entry) {
+    auto& slot = getSlot(key);
+    const std::uint64_t score = static_cast<std::uint32_t>(entry.score);
+    slot.check.store(key ^ score ^ entry.attackSpans[0] ^ entry.attackSpans[1], std::memory_order_relaxed);
+    slot.score.store(score, std::memory_order_relaxed);
+    slot.attackSpans[0].store(entry.attackSpans[0], std::memory_order_relaxed);
+    slot.attackSpans[1].store(entry.attackSpans[1], std::memory_order_relaxed);
+}
+
+inline std::ostream& operator<<(std::ostream& stream, const PawnTable::Statistics& counters) {
+    return stream << "Pawn table: " << counters.hits << "/" << counters.probes << " hits";
+}
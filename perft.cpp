@@ -0,0 +1,223 @@
+#include "board.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Shared between all threads: the key is stored xor'ed with the count, so a torn entry simply doesn't match.
+struct PerftTable {
+    struct Entry {
+        std::atomic<std::uint64_t> check{0ul};
+        std::atomic<std::uint64_t> nodes{0ul};
+    };
+    std::unique_ptr<Entry[]> entries;
+    std::size_t size{0ul};
+
+    PerftTable(std::size_t megabytes)
+        : entries(megabytes ? std::make_unique<Entry[]>(megabytes * 1024ul * 1024ul / sizeof(Entry)) : nullptr)
+        , size(megabytes * 1024ul * 1024ul / sizeof(Entry)) {}
+
+    bool get(std::uint64_t key, std::uint64_t& nodes) const {
+        if (!size) {
+            return false;
+        }
+        auto& entry = entries[key % size];
+        auto storedNodes = entry.nodes.load(std::memory_order_relaxed);
+        if ((entry.check.load(std::memory_order_relaxed) ^ storedNodes) != key) {
+            return false;
+        }
+        nodes = storedNodes;
+        return true;
+    }
+
+    void put(std::uint64_t key, std::uint64_t nodes) {
+        if (!size) {
+            return;
+        }
+        auto& entry = entries[key % size];
+        entry.check.store(key ^ nodes, std::memory_order_relaxed);
+        entry.nodes.store(nodes, std::memory_order_relaxed);
+    }
+};
+
+// The same position is counted separately for every remaining depth.
+template <bool amIWhite>
+std::uint64_t getPerftKey(const Board<amIWhite>& board, std::size_t depth) {
+    return board.getHash() ^ (depth * 0x9e3779b97f4a7c15ul);
+}
+
+template <bool amIWhite>
+std::uint64_t perft(const Board<amIWhite>& board, std::size_t depth, PerftTable& table) {
+    if (depth == 0ul) {
+        return 1ul;
+    }
+    std::uint64_t nodes = 0ul;
+    if (depth == 1ul) {
+        board.forEachLegalMove([&](const Move&) { ++nodes; });
+        return nodes;
+    }
+    auto key = getPerftKey(board, depth);
+    if (table.get(key, nodes)) {
+        return nodes;
+    }
+    board.forEachLegalMove(
+        [&](const Move& move) { nodes += perft<!amIWhite>(Board<!amIWhite>(board.applyMove(move)), depth - 1, table); });
+    table.put(key, nodes);
+    return nodes;
+}
+
+template <bool amIWhite>
+std::uint64_t divide(const Board<amIWhite>& board, std::size_t depth, std::size_t threads, bool print,
+                     PerftTable& table) {
+    std::vector<Move> moves;
+    board.forEachLegalMove([&](const Move& move) { moves.push_back(move); });
+    std::vector<std::uint64_t> counts(moves.size(), 0ul);
+    std::atomic<std::size_t> next{0ul};
+    auto work = [&]() {
+        for (auto i = next++; i < moves.size(); i = next++) {
+            counts[i] = perft<!amIWhite>(Board<!amIWhite>(board.applyMove(moves[i])), depth - 1, table);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::uint64_t nodes = 0ul;
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+        if (print) {
+            std::cout << moves[i] << ": " << counts[i] << "\n";
+        }
+        nodes += counts[i];
+    }
+    return nodes;
+}
+
+// Reads a position in Forsyth-Edwards notation, the move counters are ignored. Without the other fields the placement
+// alone is taken as white to move with castling derived from the pieces. Returns false for malformed input.
+bool parseFen(const std::string& fen, Board<true>& board, bool& amIWhite) {
+    std::istringstream stream{fen};
+    std::string placement;
+    std::string side{"w"};
+    std::string castlingField;
+    std::string enPassentField{"-"};
+    stream >> placement >> side >> castlingField >> enPassentField;
+    std::size_t squares = 0ul;
+    for (char it : placement) {
+        if (it >= '1' && it <= '8') {
+            squares += static_cast<std::size_t>(it - '0');
+        }
+        else if (std::string{"KQRBNPkqrbnp"}.find(it) != std::string::npos) {
+            ++squares;
+        }
+        else if (it != '/') {
+            return false;
+        }
+    }
+    if (squares != 64ul || (side != "w" && side != "b")) {
+        return false;
+    }
+    board = Board<true>{placement};
+    amIWhite = side == "w";
+    if (!castlingField.empty()) {
+        // in the order of Board::castling: a1, h1, a8 and h8, rights without the pieces in place stay dropped
+        const std::string letters{"QKqk"};
+        for (std::size_t i = 0; i < board.castling.size(); ++i) {
+            board.castling[i] = board.castling[i] && castlingField.find(letters[i]) != std::string::npos;
+        }
+    }
+    if (enPassentField != "-") {
+        if (enPassentField.size() != 2 || enPassentField[0] < 'a' || enPassentField[0] > 'h' ||
+            (enPassentField[1] != (amIWhite ? '6' : '3'))) {
+            return false;
+        }
+        // the field the pawn skipped, a8 is the lowest bit
+        board.enPassent = 1ul << ((enPassentField[0] - 'a') + ('8' - enPassentField[1]) * 8);
+    }
+    board.fillZobrist();
+    return true;
+}
+
+auto parseArgument(std::string arg, std::string start, int& i, int argc, char const* argv[]) -> std::string {
+    if (arg.length() > start.length()) {
+        if (arg[start.length()] == '=') {
+            return arg.substr(start.length() + 1);
+        }
+        else {
+            return arg.substr(start.length());
+        }
+    }
+    else if (i + 1 < argc) {
+        ++i;
+        return argv[i];
+    }
+    return "";
+}
+
+int main(int argc, char const* argv[]) {
+    std::string position{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"};
+    bool printDivide = false;
+    std::size_t depth = 5ul;
+    std::size_t hashSize = 0ul;
+    std::size_t threads = 1ul;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg{argv[i]};
+        if (arg.starts_with("--divide")) {
+            printDivide = true;
+        }
+        else if (arg.starts_with("--depth")) {
+            depth = std::stoul(parseArgument(arg, "--depth", i, argc, argv));
+        }
+        else if (arg.starts_with("-d")) {
+            depth = std::stoul(parseArgument(arg, "-d", i, argc, argv));
+        }
+        else if (arg.starts_with("--hash")) {
+            hashSize = std::stoul(parseArgument(arg, "--hash", i, argc, argv));
+        }
+        else if (arg.starts_with("--threads")) {
+            threads = std::stoul(parseArgument(arg, "--threads", i, argc, argv));
+        }
+        else if (arg.starts_with("-j")) {
+            threads = std::stoul(parseArgument(arg, "-j", i, argc, argv));
+        }
+        else {
+            position = arg;
+        }
+    }
+    if (depth == 0ul) {
+        std::cerr << "Error: depth must be at least 1.\n";
+        return 1;
+    }
+    if (threads == 0ul) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    Board<true> board;
+    bool amIWhite = true;
+    if (!parseFen(position, board, amIWhite)) {
+        std::cerr << "Error: \"" << position << "\" is not a valid FEN.\n";
+        return 1;
+    }
+
+    PerftTable table{hashSize};
+    auto start = std::chrono::steady_clock::now();
+    auto nodes = amIWhite ? divide<true>(board, depth, threads, printDivide, table)
+                          : divide<false>(Board<false>(board), depth, threads, printDivide, table);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    if (printDivide) {
+        std::cout << "\n";
+    }
+    std::cout << "Nodes: " << nodes << "\n";
+    std::cout << "Time: " << ms << "ms\n";
+    std::cout << "Nodes/s: " << (ms ? nodes * 1000ul / static_cast<std::uint64_t>(ms) : nodes) << "\n";
+    return 0;
+}
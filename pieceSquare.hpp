@@ -0,0 +1,172 @@
+#pragma once
+#include "piece.hpp"
+#include "zobrist.hpp"
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+namespace pieceSquare {
+
+using Table = std::array<std::int16_t, 64>;
+
+// In centipawns from white's point of view, laid out like the board: a8 first, h1 last.
+constexpr Table pawn{
+      0,   0,   0,   0,   0,   0,   0,   0,
+     50,  50,  50,  50,  50,  50,  50,  50,
+     10,  10,  20,  30,  30,  20,  10,  10,
+      5,   5,  10,  25,  25,  10,   5,   5,
+      0,   0,   0,  20,  20,   0,   0,   0,
+      5,  -5, -10,   0,   0, -10,  -5,   5,
+      5,  10,  10, -20, -20,  10,  10,   5,
+      0,   0,   0,   0,   0,   0,   0,   0};
+// passed pawns decide most end games, every step forward counts
+constexpr Table pawnEndgame{
+      0,   0,   0,   0,   0,   0,   0,   0,
+     80,  80,  80,  80,  80,  80,  80,  80,
+     50,  50,  50,  50,  50,  50,  50,  50,
+     30,  30,  30,  30,  30,  30,  30,  30,
+     15,  15,  15,  15,  15,  15,  15,  15,
+      5,   5,   5,   5,   5,   5,   5,   5,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0};
+constexpr Table knight{
+    -50, -40, -30, -30, -30, -30, -40, -50,
+    -40, -20,   0,   0,   0,   0, -20, -40,
+    -30,   0,  10,  15,  15,  10,   0, -30,
+    -30,   5,  15,  20,  20,  15,   5, -30,
+    -30,   0,  15,  20,  20,  15,   0, -30,
+    -30,   5,  10,  15,  15,  10,   5, -30,
+    -40, -20,   0,   5,   5,   0, -20, -40,
+    -50, -40, -30, -30, -30, -30, -40, -50};
+constexpr Table bishop{
+    -20, -10, -10, -10, -10, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,  10,  10,   5,   0, -10,
+    -10,   5,   5,  10,  10,   5,   5, -10,
+    -10,   0,  10,  10,  10,  10,   0, -10,
+    -10,  10,  10,  10,  10,  10,  10, -10,
+    -10,   5,   0,   0,   0,   0,   5, -10,
+    -20, -10, -10, -10, -10, -10, -10, -20};
+constexpr Table rook{
+      0,   0,   0,   0,   0,   0,   0,   0,
+      5,  10,  10,  10,  10,  10,  10,   5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+      0,   0,   0,   5,   5,   0,   0,   0};
+constexpr Table queen{
+    -20, -10, -10,  -5,  -5, -10, -10, -20,
+    -10,   0,   0,   0,   0,   0,   0, -10,
+    -10,   0,   5,   5,   5,   5,   0, -10,
+     -5,   0,   5,   5,   5,   5,   0,  -5,
+      0,   0,   5,   5,   5,   5,   0,  -5,
+    -10,   5,   5,   5,   5,   5,   0, -10,
+    -10,   0,   5,   0,   0,   0,   0, -10,
+    -20, -10, -10,  -5,  -5, -10, -10, -20};
+// behind its pawns while the queens are around
+constexpr Table king{
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -20, -30, -30, -40, -40, -30, -30, -20,
+    -10, -20, -20, -20, -20, -20, -20, -10,
+     20,  20,   0,   0,   0,   0,  20,  20,
+     20,  30,  10,   0,   0,  10,  30,  20};
+// in the center once there's nothing left to fear
+constexpr Table kingEndgame{
+    -50, -40, -30, -20, -20, -30, -40, -50,
+    -30, -20, -10,   0,   0, -10, -20, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  30,  40,  40,  30, -10, -30,
+    -30, -10,  20,  30,  30,  20, -10, -30,
+    -30, -30,   0,   0,   0,   0, -30, -30,
+    -50, -30, -30, -30, -30, -30, -30, -50};
+
+struct Tables {
+    // indexed by piece and square, black uses the white tables mirrored. Each from the point of view of its owner.
+    std::array<Table, 16> middlegame{};
+    std::array<Table, 16> endgame{};
+    // how much each piece counts towards the game phase
+    std::array<std::int16_t, 16> phase{};
+};
+
+constexpr Tables generateTables() {
+    Tables result;
+    const std::array<std::pair<piece, std::array<const Table*, 2>>, 6> white{{
+        {WhiteKing, {&king, &kingEndgame}},
+        {WhiteQueen, {&queen, &queen}},
+        {WhiteRook, {&rook, &rook}},
+        {WhiteBishop, {&bishop, &bishop}},
+        {WhiteKnight, {&knight, &knight}},
+        {WhitePawn, {&pawn, &pawnEndgame}},
+    }};
+    for (const auto& [fig, source] : white) {
+        for (std::size_t i = 0; i < 64; ++i) {
+            result.middlegame[fig][i] = (*source[0])[i];
+            result.endgame[fig][i] = (*source[1])[i];
+            // a8 becomes a1
+            result.middlegame[invertPiece(fig)][i ^ 56] = (*source[0])[i];
+            result.endgame[invertPiece(fig)][i ^ 56] = (*source[1])[i];
+        }
+    }
+    for (auto [fig, weight] : {std::pair{WhiteQueen, 4}, std::pair{WhiteRook, 2}, std::pair{WhiteBishop, 1},
+                               std::pair{WhiteKnight, 1}}) {
+        result.phase[fig] = static_cast<std::int16_t>(weight);
+        result.phase[invertPiece(fig)] = static_cast<std::int16_t>(weight);
+    }
+    return result;
+}
+
+constexpr const static auto tables = generateTables();
+
+// the phase with all pieces on the board, it only goes up by promotions
+constexpr const static int openingPhase = 24;
+
+} // namespace pieceSquare
+
+// Evaluation terms kept up to date by makeMove, so the evaluation doesn't have to look at every piece. Everything is
+// indexed like Board::figures and from the point of view of the owner of the piece.
+struct EvaluationTerms {
+    std::array<std::uint8_t, 16> counts{};
+    // sums of the piece-square values of all pieces of a kind, for the middle and the end game
+    std::array<std::int16_t, 16> middlegame{};
+    std::array<std::int16_t, 16> endgame{};
+    // openingPhase with all pieces on the board down to 0 with only kings and pawns left
+    std::int16_t phase{0};
+    // zobrist key over the pawns of both parties only, for caching the evaluation of the pawn structure
+    std::uint64_t pawnKey{0ul};
+
+    constexpr void add(piece fig, std::uint64_t pos) {
+        auto square = __builtin_ctzll(pos);
+        ++counts[fig];
+        middlegame[fig] += pieceSquare::tables.middlegame[fig][square];
+        endgame[fig] += pieceSquare::tables.endgame[fig][square];
+        phase += pieceSquare::tables.phase[fig];
+        if (fig == WhitePawn || fig == BlackPawn) {
+            pawnKey ^= zobrist::keys.pieces[fig][square];
+        }
+    }
+
+    constexpr void remove(piece fig, std::uint64_t pos) {
+        auto square = __builtin_ctzll(pos);
+        --counts[fig];
+        middlegame[fig] -= pieceSquare::tables.middlegame[fig][square];
+        endgame[fig] -= pieceSquare::tables.endgame[fig][square];
+        phase -= pieceSquare::tables.phase[fig];
+        if (fig == WhitePawn || fig == BlackPawn) {
+            pawnKey ^= zobrist::keys.pieces[fig][square];
+        }
+    }
+
+    // blends the middle and the end game value of a kind of piece by the phase
+    constexpr int getTapered(piece fig) const {
+        const int clampedPhase = phase < pieceSquare::openingPhase ? phase : pieceSquare::openingPhase;
+        return (middlegame[fig] * clampedPhase + endgame[fig] * (pieceSquare::openingPhase - clampedPhase)) /
+            pieceSquare::openingPhase;
+    }
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include "move.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Triangular table of the best lines found by the search: row ply holds the line from the node at that ply on. A move
+// that raises alpha copies the row of its child below itself, so the root row ends up with the principal variation.
+// Lines longer than maxPly are cut off.
+class PrincipalVariation {
+public:
+    constexpr const static std::size_t maxPly = 64;
+
+    // called when entering a node, until a move raises alpha its line is empty
+    void clear(std::size_t ply) {
+        if (ply < maxPly) {
+            lengths[ply] = 0;
+        }
+    }
+
+    void update(std::size_t ply, const Move& move) {
+        if (ply >= maxPly) {
+            return;
+        }
+        lines[ply][0] = move;
+        std::size_t length = 1;
+        if (ply + 1 < maxPly) {
+            for (std::size_t i = 0; i < lengths[ply + 1] && length < maxPly; ++i) {
+                lines[ply][length++] = lines[ply + 1][i];
+            }
+        }
+        lengths[ply] = length;
+    }
+
+    std::vector<Move> getLine(std::size_t ply = 0) const {
+        if (ply >= maxPly) {
+            return {};
+        }
+        return {lines[ply].begin(), lines[ply].begin() + static_cast<std::ptrdiff_t>(lengths[ply])};
+    }
+
+private:
+    std::array<std::array<Move, maxPly>, maxPly> lines;
+    std::array<std::size_t, maxPly> lengths{};
+};
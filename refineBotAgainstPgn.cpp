@@ -16,7 +16,7 @@ std::string demangle(const char* name) {
     return (status == 0) ? res.get() : name;
 }
 
-using MoveCache = std::map<Move, std::size_t>;
+using MoveCache = std::map<PackedMove, std::size_t>;
 
 std::tuple<Board<true>, MoveCache, MoveCache> getCachedMoves(std::ifstream& cacheFile) {
     std::string line;
@@ -39,105 +39,83 @@ std::tuple<Board<true>, MoveCache, MoveCache> getCachedMoves(std::ifstream& cach
     return result;
 }
 
+// Scores of all contestants for one position, kept on the stack so a search node doesn't allocate.
+constexpr std::size_t maxContestants = 64;
+using Scores = std::array<int, maxContestants>;
+
 template <std::size_t depth, bool amIWhite>
-std::vector<int> getMultipleScores(
-    const std::vector<Bot>& contestants,
-    Board<amIWhite> board,
-    std::vector<int>& bestPreviousScores [[maybe_unused]],
-    std::vector<int>& worstPreviousScores [[maybe_unused]]) {
-    if (board.figures[board.OwnKing] == 0) {
-        return std::vector<int>(
-            contestants.size(), std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max()));
+Scores getMultipleScores(
+    std::vector<Bot>& contestants,
+    BoardView<amIWhite> board,
+    Scores& bestPreviousScores [[maybe_unused]],
+    Scores& worstPreviousScores [[maybe_unused]]) {
+    Scores results;
+    if (board.position.figures[board.OwnKing] == 0) {
+        results.fill(std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max()));
+        return results;
     }
-    if (board.figures[board.EnemyKing] == 0) {
-        return std::vector<int>(
-            contestants.size(), std::min(-std::numeric_limits<int>::min(), std::numeric_limits<int>::max()));
+    if (board.position.figures[board.EnemyKing] == 0) {
+        results.fill(std::min(-std::numeric_limits<int>::min(), std::numeric_limits<int>::max()));
+        return results;
     }
     if constexpr (depth == 0) {
-        std::vector<int> results(contestants.size(), 0);
-        for (auto i : {board.OwnQueen, board.OwnRook, board.OwnBishop, board.OwnKnight, board.OwnPawn}) {
-            auto tmp = __builtin_popcountll(board.figures[i]);
-            for (std::size_t j = 0; j < contestants.size(); ++j) {
-                results[j] += tmp * contestants[j].values[i] * contestants[j].values[board.OwnFigure];
-            }
-        }
-        for (auto i : {board.EnemyQueen, board.EnemyRook, board.EnemyBishop, board.EnemyKnight, board.EnemyPawn}) {
-            auto tmp = __builtin_popcountll(board.figures[i]);
-            for (std::size_t j = 0; j < contestants.size(); ++j) {
-                results[j] += tmp * contestants[j].values[i] * contestants[j].values[board.EnemyFigure];
-            }
-        }
-        board.forEachValidMove([&](const Move& move) {
-            for (std::size_t j = 0; j < contestants.size(); ++j) {
-                results[j] += contestants[j].strengths[move.turnFrom] * contestants[j].strengths[board.OwnFigure];
-                results[j] -= contestants[j].weaknesses[board.figureAt(move.moveTo)] *
-                    contestants[j].weaknesses[board.EnemyFigure];
-            }
-        });
-        Board<!amIWhite> invertedBoard(board);
-        invertedBoard.forEachValidMove([&](const Move& move) {
-            for (std::size_t j = 0; j < contestants.size(); ++j) {
-                results[j] += contestants[j].strengths[move.turnFrom] * contestants[j].strengths[board.EnemyFigure];
-                results[j] -=
-                    contestants[j].weaknesses[board.figureAt(move.moveTo)] * contestants[j].weaknesses[board.OwnFigure];
-            }
-        });
+        // the same evaluation the bots use in their own search
         for (std::size_t j = 0; j < contestants.size(); ++j) {
-            if constexpr (!amIWhite) {
-                results[j] *= -1;
-            }
+            results[j] = contestants[j].evaluate(board);
         }
         return results;
     }
     else {
-        std::vector<Board<!amIWhite>> situations;
-        situations.reserve(64ul);
+        // all moves are made and unmade on the one position, so they are collected before the first one is made
+        FixedList<Move> moves;
         // this number needs to be within the range set by getMove for bestScore.
-        std::vector<int> bestScores(
-            contestants.size(), std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max()) + 1);
-        board.forEachValidMove([&](const Move& move) { situations.push_back(board.applyMove(move)); });
-        for (auto& it : situations) { /*
+        results.fill(std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max()) + 1);
+        board.forEachValidMove([&](const Move& move) { moves.emplace_back(move); });
+        for (const auto& move : moves) { /*
              bool skip = true;
              for (std::size_t i = 0; i < contestants.size(); ++i) {
                  // alpha-beta-pruning
-                 if (bestScores[i] < bestPreviousScores[i]) {
+                 if (results[i] < bestPreviousScores[i]) {
                      skip = false;
                  }
              }
              if (skip) {
                  continue;
              }*/
-            std::vector<int> currentScores = getMultipleScores<depth - 1>( //
+            auto undo = board.makeMove(move);
+            const auto currentScores = getMultipleScores<depth - 1>( //
                 contestants,
-                it,
+                board.flipped(),
                 bestPreviousScores,
                 worstPreviousScores);
+            board.unmakeMove(move, undo);
             for (std::size_t i = 0; i < contestants.size(); ++i) {
-                if (-currentScores[i] > bestScores[i]) {
-                    bestScores[i] = -currentScores[i];
+                if (-currentScores[i] > results[i]) {
+                    results[i] = -currentScores[i];
                 }
             }
         }
-        return bestScores;
+        return results;
     }
 }
 
 template <std::size_t depth, bool amIWhite>
-std::vector<Move> getMultipleMoves(const std::vector<Bot>& contestants, Board<amIWhite> board) {
-
+std::vector<Move> getMultipleMoves(std::vector<Bot>& contestants, Board<amIWhite> board) {
+    assert(contestants.size() <= maxContestants);
     std::vector<Move> bestMoves(contestants.size(), board.getFirstValidMove());
-    std::vector<int> bestScores(
-        contestants.size(), std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max()));
-    std::vector<int> worstScores(
-        contestants.size(), -std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max()));
+    Scores bestScores;
+    bestScores.fill(std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max()));
+    Scores worstScores;
+    worstScores.fill(-std::max(std::numeric_limits<int>::min(), -std::numeric_limits<int>::max()));
 
-    std::size_t moveCounter = 0;
-    board.forEachValidMove([&](auto) { ++moveCounter; });
-    std::cout << "moves: " << std::setw(3) << moveCounter << " ";
+    FixedList<Move> moves;
+    board.forEachValidMove([&](const Move& move) { moves.emplace_back(move); });
+    std::cout << "moves: " << std::setw(3) << moves.size() << " ";
 
-    board.forEachValidMove([&](auto move) {
-        Board<!amIWhite> tmp = board.applyMove(move);
-        auto currentScores = getMultipleScores<depth - 1>(contestants, tmp, bestScores, worstScores);
+    for (const auto& move : moves) {
+        auto undo = board.makeMove(move);
+        const auto currentScores = getMultipleScores<depth - 1>(contestants, board.flipped(), bestScores, worstScores);
+        board.unmakeMove(move, undo);
         std::cout << "." << std::flush;
         for (std::size_t i = 0; i < contestants.size(); ++i) {
             if (-currentScores[i] > bestScores[i]) {
@@ -145,7 +123,7 @@ std::vector<Move> getMultipleMoves(const std::vector<Bot>& contestants, Board<am
                 bestMoves[i] = move;
             }
         }
-    });
+    }
     std::cout << "\n";
     return bestMoves;
 }
@@ -179,8 +157,8 @@ void printColNumbers(std::size_t generationSize) {
 
 void saveCache(
     std::map<Bot, std::pair<std::size_t, std::size_t>>& knownBots,
-    std::map<Bot, std::map<Board<true>, Move>>& whiteMoveCache,
-    std::map<Bot, std::map<Board<false>, Move>>& blackMoveCache,
+    std::map<Bot, std::map<Board<true>, PackedMove>>& whiteMoveCache,
+    std::map<Bot, std::map<Board<false>, PackedMove>>& blackMoveCache,
     std::size_t startLines,
     double mutationIntensity,
     const std::string& filename) {
@@ -221,21 +199,23 @@ void saveCache(
 
     std::ofstream out(filename.c_str(), std::ios_base::binary);
 
+    Bot::writeFileHeader(out);
     auto vecSize = knownBots.size();
     out.write(reinterpret_cast<const char*>(&vecSize), sizeof(vecSize));
     for (auto& it : knownBots) {
-        out.write(reinterpret_cast<const char*>(&it.first), sizeof(it.first));
-        out.write(reinterpret_cast<const char*>(&it.second), sizeof(it.second));
+        it.first.write(out);
+        out.write(reinterpret_cast<const char*>(&it.second.first), sizeof(it.second.first));
+        out.write(reinterpret_cast<const char*>(&it.second.second), sizeof(it.second.second));
     }
     out.write("====", 4);
     vecSize = whiteMoveCache.size();
     out.write(reinterpret_cast<const char*>(&vecSize), sizeof(vecSize));
     for (auto& it : whiteMoveCache) {
-        out.write(reinterpret_cast<const char*>(&it.first), sizeof(it.first));
+        it.first.write(out);
         auto subVecSize = it.second.size();
         out.write(reinterpret_cast<const char*>(&subVecSize), sizeof(subVecSize));
         for (auto& jt : it.second) {
-            out.write(reinterpret_cast<const char*>(&jt.first), sizeof(jt.first));
+            jt.first.write(out);
             out.write(reinterpret_cast<const char*>(&jt.second), sizeof(jt.second));
         }
     }
@@ -243,11 +223,11 @@ void saveCache(
     vecSize = blackMoveCache.size();
     out.write(reinterpret_cast<const char*>(&vecSize), sizeof(vecSize));
     for (auto& it : blackMoveCache) {
-        out.write(reinterpret_cast<const char*>(&it.first), sizeof(it.first));
+        it.first.write(out);
         auto subVecSize = it.second.size();
         out.write(reinterpret_cast<const char*>(&subVecSize), sizeof(subVecSize));
         for (auto& jt : it.second) {
-            out.write(reinterpret_cast<const char*>(&jt.first), sizeof(jt.first));
+            jt.first.write(out);
             out.write(reinterpret_cast<const char*>(&jt.second), sizeof(jt.second));
         }
     }
@@ -261,26 +241,34 @@ void saveCache(
 
 auto loadCache(const std::string& filename) -> std::tuple<
     std::map<Bot, std::pair<std::size_t, std::size_t>>,
-    std::map<Bot, std::map<Board<true>, Move>>,
-    std::map<Bot, std::map<Board<false>, Move>>,
+    std::map<Bot, std::map<Board<true>, PackedMove>>,
+    std::map<Bot, std::map<Board<false>, PackedMove>>,
     std::size_t,
     double> {
 
     std::ifstream in(filename.c_str(), std::ios_base::binary);
 
     std::map<Bot, std::pair<std::size_t, std::size_t>> knownBots;
-    std::map<Bot, std::map<Board<true>, Move>> whiteMoveCache;
-    std::map<Bot, std::map<Board<false>, Move>> blackMoveCache;
+    std::map<Bot, std::map<Board<true>, PackedMove>> whiteMoveCache;
+    std::map<Bot, std::map<Board<false>, PackedMove>> blackMoveCache;
     std::size_t startLines = 10ul;
     double mutationIntensity = 0.4;
     // TODO(mstaff): error handling
+    if (!Bot::readFileHeader(in)) {
+        std::cout << "Could not read persistence file.\nStart lines: ";
+        std::cin >> startLines;
+        std::cout << "Mutation intensity: ";
+        std::cin >> mutationIntensity;
+        return std::tuple{knownBots, whiteMoveCache, blackMoveCache, startLines, mutationIntensity};
+    }
     auto vecSize = knownBots.size();
     in.read(reinterpret_cast<char*>(&vecSize), sizeof(vecSize));
     for (decltype(vecSize) i = 0; i < vecSize; ++i) {
         Bot currentBot;
         std::pair<std::size_t, std::size_t> currentScore;
-        in.read(reinterpret_cast<char*>(&currentBot), sizeof(currentBot));
-        in.read(reinterpret_cast<char*>(&currentScore), sizeof(currentScore));
+        currentBot.read(in);
+        in.read(reinterpret_cast<char*>(&currentScore.first), sizeof(currentScore.first));
+        in.read(reinterpret_cast<char*>(&currentScore.second), sizeof(currentScore.second));
         knownBots[currentBot] = currentScore;
     }
     std::string divider = "0000";
@@ -300,12 +288,12 @@ auto loadCache(const std::string& filename) -> std::tuple<
     for (decltype(vecSize) i = 0; i < vecSize; ++i) {
         decltype(vecSize) subVecSize;
         Bot currentBot;
-        in.read(reinterpret_cast<char*>(&currentBot), sizeof(currentBot));
+        currentBot.read(in);
         in.read(reinterpret_cast<char*>(&subVecSize), sizeof(subVecSize));
         for (decltype(subVecSize) j = 0; j < subVecSize; ++j) {
             Board<true> currentBoard;
-            Move currentMove;
-            in.read(reinterpret_cast<char*>(&currentBoard), sizeof(currentBoard));
+            PackedMove currentMove;
+            currentBoard.read(in);
             in.read(reinterpret_cast<char*>(&currentMove), sizeof(currentMove));
             whiteMoveCache[currentBot][currentBoard] = currentMove;
         }
@@ -326,12 +314,12 @@ auto loadCache(const std::string& filename) -> std::tuple<
     for (decltype(vecSize) i = 0; i < vecSize; ++i) {
         decltype(vecSize) subVecSize;
         Bot currentBot;
-        in.read(reinterpret_cast<char*>(&currentBot), sizeof(currentBot));
+        currentBot.read(in);
         in.read(reinterpret_cast<char*>(&subVecSize), sizeof(subVecSize));
         for (decltype(subVecSize) j = 0; j < subVecSize; ++j) {
-            Board<true> currentBoard;
-            Move currentMove;
-            in.read(reinterpret_cast<char*>(&currentBoard), sizeof(currentBoard));
+            Board<false> currentBoard;
+            PackedMove currentMove;
+            currentBoard.read(in);
             in.read(reinterpret_cast<char*>(&currentMove), sizeof(currentMove));
             blackMoveCache[currentBot][currentBoard] = currentMove;
         }
@@ -387,6 +375,8 @@ int main(int argc [[maybe_unused]], char const* argv [[maybe_unused]][]) {
     std::size_t maxScore = 1;
     std::size_t minScore = 0;
     Bot newContestant{};
+    // shared by all contestants, the entries are keyed by the parameters of each bot as well
+    PawnTable pawnTable{4ul};
     auto [knownBots, whiteMoveCache, blackMoveCache, startLines, mutationIntensity] = loadCache(botCacheFilename);
     {
         auto whiteMoveCount =
@@ -492,7 +482,9 @@ int main(int argc [[maybe_unused]], char const* argv [[maybe_unused]][]) {
                         }
                     }
                     else {
-                        currentGen.push_back(it.first);
+                        auto& bot = currentGen.emplace_back(it.first);
+                        bot.pawnTable = &pawnTable;
+                        bot.parameterKey = bot.getParameterKey();
                     }
                 }
             }
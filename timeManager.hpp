@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Decides how long a search may take. The soft deadline is checked before starting another iteration, the hard
+// deadline is polled from within the search and stops it in the middle of an iteration.
+class TimeManager {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // without any limit
+    TimeManager()
+        : start(clock::now())
+        , softDeadline(clock::time_point::max())
+        , hardDeadline(clock::time_point::max()) {}
+
+    // a fixed time for this move, the next iteration would rarely finish once half of it is gone
+    explicit TimeManager(clock::duration moveTime)
+        : start(clock::now())
+        , softDeadline(getDeadline(moveTime / 2))
+        , hardDeadline(getDeadline(moveTime)) {}
+
+    TimeManager(clock::duration softLimit, clock::duration hardLimit)
+        : start(clock::now())
+        , softDeadline(getDeadline(softLimit))
+        , hardDeadline(getDeadline(hardLimit)) {}
+
+    // Spreads the remaining time on the clock over the expected rest of the game. A single move may take up to three
+    // times its share, but never more than a third of what is left.
+    static TimeManager forClock(clock::duration remaining, clock::duration increment, std::size_t movesToGo = 30) {
+        // keeps some time for the process start and the communication
+        const auto available = std::max(remaining - std::chrono::milliseconds{50}, clock::duration{0});
+        const auto share = available / static_cast<long>(std::max(movesToGo, std::size_t{1})) + increment * 3 / 4;
+        const auto hardLimit = std::min(share * 3, available / 3 + increment);
+        return TimeManager{std::min(share, hardLimit) / 2, hardLimit};
+    }
+
+    bool canStartIteration() const { return !isStopped() && clock::now() < softDeadline; }
+
+    // polled from within the search, a stop is sticky
+    bool isOutOfTime() {
+        if (!isStopped() && clock::now() >= hardDeadline) {
+            stop();
+        }
+        return isStopped();
+    }
+
+    bool isStopped() const { return stopped.load(std::memory_order_relaxed); }
+    void stop() { stopped.store(true, std::memory_order_relaxed); }
+
+    clock::duration getElapsed() const { return clock::now() - start; }
+
+private:
+    clock::time_point getDeadline(clock::duration limit) const {
+        return limit >= clock::time_point::max() - start ? clock::time_point::max() : start + limit;
+    }
+
+    clock::time_point start;
+    clock::time_point softDeadline;
+    clock::time_point hardDeadline;
+    std::atomic<bool> stopped{false};
+};
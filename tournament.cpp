@@ -123,73 +123,82 @@ void Tournament::playGame(
     std::map<Board<false>, std::size_t> reverseBoardCounter;
 
     while (true) {
-        if (reverseSituation.isThreatened(reverseSituation.figures[BlackKing])) {
-            bot1->second += 3;
-            *result = whiteWon;
+        // the generated moves are strictly legal, so running out of them means checkmate or stalemate
+        if (currentSituation.getFirstLegalMove() == Move{}) {
+            if (currentSituation.isInCheck()) {
+                bot2->second += 3;
+                *result = blackWon;
+            }
+            else {
+                bot1->second += 1;
+                bot2->second += 1;
+                *result = draw;
+            }
             return;
         }
-        if (currentSituation.getFirstValidMove() == Move{} || currentBoardCounter[currentSituation] > 10) {
+        if (currentBoardCounter[currentSituation] > 10) {
             bot1->second += 1;
             bot2->second += 1;
             *result = draw;
             return;
         }
         if (whiteMoveCache.count(bot1->first) && whiteMoveCache.at(bot1->first).count(currentSituation)) {
-            whiteMove = whiteMoveCache.at(bot1->first).at(currentSituation);
+            whiteMove = currentSituation.unpackMove(whiteMoveCache.at(bot1->first).at(currentSituation));
         }
         else {
-            whiteMove = bot1->first.getMove<4, false>(currentSituation);
+            whiteMove = bot1->first.getMove<false>(currentSituation, 4).move;
             whiteMoveCache[bot1->first][currentSituation] = whiteMove;
         }
         reverseSituation = currentSituation.applyMove(whiteMove);
         ++reverseBoardCounter[reverseSituation];
-        if (currentSituation.figures[BlackKing] == 0ul) {
-            bot1->second += 3;
-            *result = whiteWon;
-            return;
-        }
-        if (currentSituation.isThreatened(currentSituation.figures[WhiteKing])) {
-            bot2->second += 3;
-            *result = blackWon;
+        if (reverseSituation.getFirstLegalMove() == Move{}) {
+            if (reverseSituation.isInCheck()) {
+                bot1->second += 3;
+                *result = whiteWon;
+            }
+            else {
+                bot1->second += 1;
+                bot2->second += 1;
+                *result = draw;
+            }
             return;
         }
-        if (reverseSituation.getFirstValidMove() == Move{} || reverseBoardCounter[reverseSituation] > 10) {
+        if (reverseBoardCounter[reverseSituation] > 10) {
             bot1->second += 1;
             bot2->second += 1;
             *result = draw;
             return;
         }
         if (blackMoveCache.count(bot2->first) && blackMoveCache.at(bot2->first).count(reverseSituation)) {
-            blackMove = blackMoveCache.at(bot2->first).at(reverseSituation);
+            blackMove = reverseSituation.unpackMove(blackMoveCache.at(bot2->first).at(reverseSituation));
         }
         else {
-            blackMove = bot2->first.getMove<4, false>(reverseSituation);
+            blackMove = bot2->first.getMove<false>(reverseSituation, 4).move;
             blackMoveCache[bot2->first][reverseSituation] = blackMove;
         }
         currentSituation = reverseSituation.applyMove(blackMove);
         ++currentBoardCounter[currentSituation];
-        if (currentSituation.figures[WhiteKing] == 0ul) {
-            bot2->second += 3;
-            *result = blackWon;
-            return;
-        }
     }
     __builtin_unreachable();
 }
 
 void Tournament::saveTournament(std::ofstream& out) const {
+    Bot::writeFileHeader(out);
     auto vecSize = contestants.size();
     out.write(reinterpret_cast<const char*>(&vecSize), sizeof(vecSize));
-    out.write(reinterpret_cast<const char*>(contestants.data()), sizeof(*contestants.data()) * vecSize);
+    for (auto& it : contestants) {
+        it.first.write(out);
+        out.write(reinterpret_cast<const char*>(&it.second), sizeof(it.second));
+    }
     out.write("====", 4);
     vecSize = whiteMoveCache.size();
     out.write(reinterpret_cast<const char*>(&vecSize), sizeof(vecSize));
     for (auto& it : whiteMoveCache) {
-        out.write(reinterpret_cast<const char*>(&it.first), sizeof(it.first));
+        it.first.write(out);
         auto subVecSize = it.second.size();
         out.write(reinterpret_cast<const char*>(&subVecSize), sizeof(subVecSize));
         for (auto& jt : it.second) {
-            out.write(reinterpret_cast<const char*>(&jt.first), sizeof(jt.first));
+            jt.first.write(out);
             out.write(reinterpret_cast<const char*>(&jt.second), sizeof(jt.second));
         }
     }
@@ -197,11 +206,11 @@ void Tournament::saveTournament(std::ofstream& out) const {
     vecSize = blackMoveCache.size();
     out.write(reinterpret_cast<const char*>(&vecSize), sizeof(vecSize));
     for (auto& it : blackMoveCache) {
-        out.write(reinterpret_cast<const char*>(&it.first), sizeof(it.first));
+        it.first.write(out);
         auto subVecSize = it.second.size();
         out.write(reinterpret_cast<const char*>(&subVecSize), sizeof(subVecSize));
         for (auto& jt : it.second) {
-            out.write(reinterpret_cast<const char*>(&jt.first), sizeof(jt.first));
+            jt.first.write(out);
             out.write(reinterpret_cast<const char*>(&jt.second), sizeof(jt.second));
         }
     }
@@ -210,10 +219,19 @@ void Tournament::saveTournament(std::ofstream& out) const {
 
 void Tournament::loadTournament(std::ifstream& in) {
     // TODO(mstaff): error handling
+    if (!Bot::readFileHeader(in)) {
+        contestants.clear();
+        whiteMoveCache.clear();
+        blackMoveCache.clear();
+        return;
+    }
     auto vecSize = contestants.size();
     in.read(reinterpret_cast<char*>(&vecSize), sizeof(vecSize));
     contestants.resize(vecSize);
-    in.read(reinterpret_cast<char*>(contestants.data()), sizeof(*contestants.data()) * vecSize);
+    for (auto& it : contestants) {
+        it.first.read(in);
+        in.read(reinterpret_cast<char*>(&it.second), sizeof(it.second));
+    }
     std::string divider = "0000";
     in.read(divider.data(), 4);
     if (divider != "====") {
@@ -226,12 +244,12 @@ void Tournament::loadTournament(std::ifstream& in) {
     for (decltype(vecSize) i = 0; i < vecSize; ++i) {
         decltype(vecSize) subVecSize;
         Bot currentBot;
-        in.read(reinterpret_cast<char*>(&currentBot), sizeof(currentBot));
+        currentBot.read(in);
         in.read(reinterpret_cast<char*>(&subVecSize), sizeof(subVecSize));
         for (decltype(subVecSize) j = 0; j < subVecSize; ++j) {
             Board<true> currentBoard;
-            Move currentMove;
-            in.read(reinterpret_cast<char*>(&currentBoard), sizeof(currentBoard));
+            PackedMove currentMove;
+            currentBoard.read(in);
             in.read(reinterpret_cast<char*>(&currentMove), sizeof(currentMove));
             whiteMoveCache[currentBot][currentBoard] = currentMove;
         }
@@ -247,12 +265,12 @@ void Tournament::loadTournament(std::ifstream& in) {
     for (decltype(vecSize) i = 0; i < vecSize; ++i) {
         decltype(vecSize) subVecSize;
         Bot currentBot;
-        in.read(reinterpret_cast<char*>(&currentBot), sizeof(currentBot));
+        currentBot.read(in);
         in.read(reinterpret_cast<char*>(&subVecSize), sizeof(subVecSize));
         for (decltype(subVecSize) j = 0; j < subVecSize; ++j) {
-            Board<true> currentBoard;
-            Move currentMove;
-            in.read(reinterpret_cast<char*>(&currentBoard), sizeof(currentBoard));
+            Board<false> currentBoard;
+            PackedMove currentMove;
+            currentBoard.read(in);
             in.read(reinterpret_cast<char*>(&currentMove), sizeof(currentMove));
             blackMoveCache[currentBot][currentBoard] = currentMove;
         }
@@ -17,8 +17,8 @@ enum outcome {
 class Tournament {
 private:
     std::vector<std::pair<Bot, int>> contestants;
-    std::map<Bot, std::map<Board<true>, Move>> whiteMoveCache;
-    std::map<Bot, std::map<Board<false>, Move>> blackMoveCache;
+    std::map<Bot, std::map<Board<true>, PackedMove>> whiteMoveCache;
+    std::map<Bot, std::map<Board<false>, PackedMove>> blackMoveCache;
 
     void playGame(
         std::vector<std::pair<Bot, int>>::iterator bot1,
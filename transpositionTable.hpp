@@ -0,0 +1,138 @@
+#pragma once
+#include "move.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+// Search results of previously visited positions, shared between all search threads without locks. Every entry is two
+// words and the first one holds the key xor'ed with the second, so a torn write simply doesn't match on the next probe.
+// Four entries make up one bucket of one cache line, a position can only be stored in the bucket its key points to.
+class TranspositionTable {
+public:
+    enum Bound : std::uint8_t { NoBound = 0, UpperBound = 1, LowerBound = 2, ExactBound = 3 };
+
+    struct Entry {
+        int score{0};
+        std::uint8_t depth{0};
+        Bound bound{NoBound};
+        PackedMove move{};
+    };
+
+    // Counted by the caller, so concurrent searches don't contend over shared counters.
+    struct Statistics {
+        std::uint64_t probes{0ul};
+        std::uint64_t hits{0ul};
+        std::uint64_t stores{0ul};
+        // a store replaced the entry of a different position
+        std::uint64_t collisions{0ul};
+    };
+
+    TranspositionTable(std::size_t megabytes);
+
+    bool probe(std::uint64_t key, Entry& result, Statistics& counters) const;
+    void store(std::uint64_t key, const Entry& entry, Statistics& counters);
+    // marks all entries as outdated without touching the memory, they get replaced first
+    void nextGeneration() { generation = (generation + 1) & generationMask; }
+
+    std::size_t getSize() const { return bucketCount * entriesPerBucket; }
+
+private:
+    constexpr const static std::size_t entriesPerBucket = 4;
+    constexpr const static std::uint64_t generationMask = 0b111111ul;
+
+    struct Slot {
+        std::atomic<std::uint64_t> check{0ul};
+        std::atomic<std::uint64_t> data{0ul};
+    };
+
+    struct alignas(64) Bucket {
+        std::array<Slot, entriesPerBucket> slots;
+    };
+
+    // score in the low 32 bits, then move, depth, bound and generation
+    static std::uint64_t pack(const Entry& entry, std::uint64_t generation) {
+        return static_cast<std::uint32_t>(entry.score) | static_cast<std::uint64_t>(entry.move.data) << 32 |
+            static_cast<std::uint64_t>(entry.depth) << 48 | static_cast<std::uint64_t>(entry.bound) << 56 |
+            generation << 58;
+    }
+
+    static Entry unpack(std::uint64_t data) {
+        Entry result;
+        result.score = static_cast<int>(static_cast<std::uint32_t>(data));
+        result.move.data = static_cast<std::uint16_t>(data >> 32);
+        result.depth = static_cast<std::uint8_t>(data >> 48);
+        result.bound = static_cast<Bound>((data >> 56) & 0b11ul);
+        return result;
+    }
+
+    Bucket& getBucket(std::uint64_t key) const {
+        // maps the key onto the buckets without a division
+        return buckets[static_cast<std::size_t>((static_cast<unsigned __int128>(key) * bucketCount) >> 64)];
+    }
+
+    std::unique_ptr<Bucket[]> buckets;
+    std::size_t bucketCount{0ul};
+    std::uint64_t generation{0ul};
+};
+
+inline TranspositionTable::TranspositionTable(std::size_t megabytes)
+    : buckets(std::make_unique<Bucket[]>(std::max(megabytes * 1024ul * 1024ul / sizeof(Bucket), 1ul)))
+    , bucketCount(std::max(megabytes * 1024ul * 1024ul / sizeof(Bucket), 1ul)) {}
+
+inline bool TranspositionTable::probe(std::uint64_t key, Entry& result, Statistics& counters) const {
+    ++counters.probes;
+    for (auto& slot : getBucket(key).slots) {
+        auto data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.check.load(std::memory_order_relaxed) ^ data) == key && data) {
+            result = unpack(data);
+            ++counters.hits;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Replaces the entry of the same position if there is one, otherwise an empty, an outdated or the shallowest entry.
+inline void TranspositionTable::store(std::uint64_t key, const Entry& entry, Statistics& counters) {
+    ++counters.stores;
+    Slot* replaced = nullptr;
+    std::uint64_t replacedData = 0ul;
+    int replacedWorth = std::numeric_limits<int>::max();
+    for (auto& slot : getBucket(key).slots) {
+        auto data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+            // keep the known best move if the new result didn't find one
+            auto newEntry = entry;
+            if (newEntry.move == PackedMove{}) {
+                newEntry.move = unpack(data).move;
+            }
+            slot.check.store(key ^ pack(newEntry, generation), std::memory_order_relaxed);
+            slot.data.store(pack(newEntry, generation), std::memory_order_relaxed);
+            return;
+        }
+        int worth = data ? static_cast<int>((data >> 48) & 0xfful) : -512;
+        if (data && ((data >> 58) & generationMask) != generation) {
+            worth -= 256;
+        }
+        if (worth < replacedWorth) {
+            replaced = &slot;
+            replacedData = data;
+            replacedWorth = worth;
+        }
+    }
+    if (replacedData) {
+        ++counters.collisions;
+    }
+    replaced->check.store(key ^ pack(entry, generation), std::memory_order_relaxed);
+    replaced->data.store(pack(entry, generation), std::memory_order_relaxed);
+}
+
+inline std::ostream& operator<<(std::ostream& stream, const TranspositionTable::Statistics& counters) {
+    return stream << "Hash table: " << counters.hits << "/" << counters.probes << " hits, " << counters.stores
+                  << " stores, " << counters.collisions << " collisions";
+}
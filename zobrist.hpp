@@ -0,0 +1,55 @@
+#pragma once
+#include "piece.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace zobrist {
+
+// splitmix64, generated at compile time so keys are identical between runs and programs.
+constexpr std::uint64_t nextRandom(std::uint64_t& state) {
+    state += 0x9e3779b97f4a7c15ul;
+    auto x = state;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ul;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebul;
+    return x ^ (x >> 31);
+}
+
+struct Keys {
+    // indexed by piece and square, the rows of None and the cached figure sets stay zero
+    std::array<std::array<std::uint64_t, 64>, 16> pieces{};
+    std::array<std::uint64_t, 4> castling{};
+    std::array<std::uint64_t, 8> enPassentFile{};
+    std::uint64_t blackToMove{0ul};
+};
+
+constexpr Keys generateKeys() {
+    Keys result;
+    std::uint64_t state = 0x5363686163686269ul;
+    for (auto fig : {WhiteKing, WhiteQueen, WhiteRook, WhiteBishop, WhiteKnight, WhitePawn, BlackKing, BlackQueen,
+                     BlackRook, BlackBishop, BlackKnight, BlackPawn}) {
+        for (auto& it : result.pieces[fig]) {
+            it = nextRandom(state);
+        }
+    }
+    for (auto& it : result.castling) {
+        it = nextRandom(state);
+    }
+    for (auto& it : result.enPassentFile) {
+        it = nextRandom(state);
+    }
+    result.blackToMove = nextRandom(state);
+    return result;
+}
+
+constexpr const static auto keys = generateKeys();
+
+constexpr std::uint64_t pieceKey(piece fig, std::uint64_t pos) {
+    return keys.pieces[fig][__builtin_ctzll(pos)];
+}
+
+constexpr std::uint64_t enPassentKey(std::uint64_t enPassent) {
+    return enPassent ? keys.enPassentFile[__builtin_ctzll(enPassent) % 8] : 0ul;
+}
+
+} // namespace zobrist